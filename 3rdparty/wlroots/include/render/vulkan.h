@@ -290,6 +290,11 @@ struct wlr_vk_command_buffer {
 
 #define VULKAN_COMMAND_BUFFERS_CAP 64
 
+struct waylib_vk_wait_semaphore {
+	VkSemaphore semaphore;
+	uint64_t timeline_point;
+};
+
 // Vulkan wlr_renderer implementation on top of a wlr_vk_device.
 struct wlr_vk_renderer {
 	struct wlr_renderer wlr_renderer;
@@ -348,6 +353,12 @@ struct wlr_vk_renderer {
 		struct wl_list buffers; // wlr_vk_shared_buffer.link
 	} stage;
 
+	// waylib: semaphores of queued sync_file waits, reusable once the
+	// timeline reaches their point
+	struct wl_array waylib_wait_semaphores; // struct waylib_vk_wait_semaphore
+	// waylib: signalled after Qt's frames and exported as a sync_file
+	VkSemaphore waylib_frame_semaphore;
+
 	struct {
 		bool initialized;
 		uint32_t drm_format;
@@ -48,5 +48,11 @@ bool waylib_vk_renderer_record_render_buffer_acquire(struct wlr_renderer *render
 bool waylib_vk_renderer_record_render_buffer_release(struct wlr_renderer *renderer,
 	struct wlr_buffer *buffer, VkCommandBuffer cb, VkImageLayout old_layout);
 bool waylib_vk_renderer_flush_stage(struct wlr_renderer *renderer);
+/* Makes everything submitted to the queue afterwards wait for the sync_file
+ * on the GPU. Takes the fd, also on failure. */
+bool waylib_vk_renderer_wait_sync_file(struct wlr_renderer *renderer, int sync_file_fd);
+/* Returns a sync_file signalled once everything submitted to the queue so far
+ * completed, or -1. */
+int waylib_vk_renderer_export_sync_file(struct wlr_renderer *renderer);
 
 #endif
@@ -1111,6 +1111,164 @@ bool waylib_vk_renderer_record_render_buffer_release(struct wlr_renderer *wlr_re
 	return true;
 }
 
+bool waylib_vk_renderer_wait_sync_file(struct wlr_renderer *wlr_renderer, int sync_file_fd) {
+	assert(wlr_renderer_is_vk(wlr_renderer));
+	struct wlr_vk_renderer *renderer = vulkan_get_renderer(wlr_renderer);
+	VkResult res;
+
+	if (!renderer->dev->sync_file_import_export) {
+		close(sync_file_fd);
+		return false;
+	}
+
+	uint64_t current_point;
+	res = renderer->dev->api.vkGetSemaphoreCounterValueKHR(renderer->dev->dev,
+		renderer->timeline_semaphore, &current_point);
+	if (res != VK_SUCCESS) {
+		wlr_vk_error("vkGetSemaphoreCounterValueKHR", res);
+		close(sync_file_fd);
+		return false;
+	}
+
+	// Reuse a semaphore whose previous wait already completed
+	struct waylib_vk_wait_semaphore *wait = NULL, *iter;
+	wl_array_for_each(iter, &renderer->waylib_wait_semaphores) {
+		if (iter->timeline_point <= current_point) {
+			wait = iter;
+			break;
+		}
+	}
+	if (wait == NULL) {
+		VkSemaphoreCreateInfo semaphore_info = {
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+		};
+		VkSemaphore semaphore;
+		res = vkCreateSemaphore(renderer->dev->dev, &semaphore_info, NULL, &semaphore);
+		if (res != VK_SUCCESS) {
+			wlr_vk_error("vkCreateSemaphore", res);
+			close(sync_file_fd);
+			return false;
+		}
+		wait = wl_array_add(&renderer->waylib_wait_semaphores, sizeof(*wait));
+		if (wait == NULL) {
+			vkDestroySemaphore(renderer->dev->dev, semaphore, NULL);
+			close(sync_file_fd);
+			return false;
+		}
+		*wait = (struct waylib_vk_wait_semaphore){
+			.semaphore = semaphore,
+		};
+	}
+
+	VkImportSemaphoreFdInfoKHR import_info = {
+		.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR,
+		.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+		.flags = VK_SEMAPHORE_IMPORT_TEMPORARY_BIT,
+		.semaphore = wait->semaphore,
+		.fd = sync_file_fd,
+	};
+	res = renderer->dev->api.vkImportSemaphoreFdKHR(renderer->dev->dev, &import_info);
+	if (res != VK_SUCCESS) {
+		wlr_vk_error("vkImportSemaphoreFdKHR", res);
+		close(sync_file_fd);
+		return false;
+	}
+
+	// With vkQueueSubmit2 the wait also covers every command submitted later,
+	// so an empty batch holds back the next frame of the Qt Quick renderer
+	// sharing this queue.
+	uint64_t timeline_point = ++renderer->timeline_point;
+	VkSemaphoreSubmitInfoKHR wait_info = {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+		.semaphore = wait->semaphore,
+		.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+	};
+	VkSemaphoreSubmitInfoKHR signal_info = {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+		.semaphore = renderer->timeline_semaphore,
+		.value = timeline_point,
+		.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+	};
+	VkSubmitInfo2KHR submit_info = {
+		.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR,
+		.waitSemaphoreInfoCount = 1,
+		.pWaitSemaphoreInfos = &wait_info,
+		.signalSemaphoreInfoCount = 1,
+		.pSignalSemaphoreInfos = &signal_info,
+	};
+	res = renderer->dev->api.vkQueueSubmit2KHR(renderer->dev->queue, 1, &submit_info, VK_NULL_HANDLE);
+	if (res != VK_SUCCESS) {
+		wlr_vk_error("vkQueueSubmit2KHR", res);
+		// The imported payload was never waited on, don't reuse the semaphore
+		wait->timeline_point = UINT64_MAX;
+		return false;
+	}
+
+	wait->timeline_point = timeline_point;
+	return true;
+}
+
+int waylib_vk_renderer_export_sync_file(struct wlr_renderer *wlr_renderer) {
+	assert(wlr_renderer_is_vk(wlr_renderer));
+	struct wlr_vk_renderer *renderer = vulkan_get_renderer(wlr_renderer);
+	VkResult res;
+
+	if (!renderer->dev->sync_file_import_export) {
+		return -1;
+	}
+
+	if (renderer->waylib_frame_semaphore == VK_NULL_HANDLE) {
+		VkExportSemaphoreCreateInfo export_info = {
+			.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO,
+			.handleTypes = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+		};
+		VkSemaphoreCreateInfo semaphore_info = {
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+			.pNext = &export_info,
+		};
+		res = vkCreateSemaphore(renderer->dev->dev, &semaphore_info, NULL,
+			&renderer->waylib_frame_semaphore);
+		if (res != VK_SUCCESS) {
+			wlr_vk_error("vkCreateSemaphore", res);
+			return -1;
+		}
+	}
+
+	// With vkQueueSubmit2 the signal also waits for every command submitted
+	// before, including the Qt Quick renderer's frames.
+	VkSemaphoreSubmitInfoKHR signal_info = {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+		.semaphore = renderer->waylib_frame_semaphore,
+		.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+	};
+	VkSubmitInfo2KHR submit_info = {
+		.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR,
+		.signalSemaphoreInfoCount = 1,
+		.pSignalSemaphoreInfos = &signal_info,
+	};
+	res = renderer->dev->api.vkQueueSubmit2KHR(renderer->dev->queue, 1, &submit_info, VK_NULL_HANDLE);
+	if (res != VK_SUCCESS) {
+		wlr_vk_error("vkQueueSubmit2KHR", res);
+		return -1;
+	}
+
+	// Note: vkGetSemaphoreFdKHR implicitly resets the semaphore
+	const VkSemaphoreGetFdInfoKHR get_fence_fd_info = {
+		.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+		.semaphore = renderer->waylib_frame_semaphore,
+		.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_SYNC_FD_BIT,
+	};
+	int sync_file_fd = -1;
+	res = renderer->dev->api.vkGetSemaphoreFdKHR(renderer->dev->dev,
+		&get_fence_fd_info, &sync_file_fd);
+	if (res != VK_SUCCESS) {
+		wlr_vk_error("vkGetSemaphoreFdKHR", res);
+		return -1;
+	}
+
+	return sync_file_fd;
+}
+
 static bool buffer_export_sync_file(struct wlr_vk_renderer *renderer, struct wlr_buffer *buffer,
 		uint32_t flags, int sync_file_fds[static WLR_DMABUF_MAX_PLANES]) {
 	struct wlr_dmabuf_attributes dmabuf = {0};
@@ -1281,6 +1439,15 @@ static void vulkan_destroy(struct wlr_renderer *wlr_renderer) {
 		wl_array_release(&cb->wait_semaphores);
 	}
 
+	struct waylib_vk_wait_semaphore *waylib_wait;
+	wl_array_for_each(waylib_wait, &renderer->waylib_wait_semaphores) {
+		vkDestroySemaphore(renderer->dev->dev, waylib_wait->semaphore, NULL);
+	}
+	wl_array_release(&renderer->waylib_wait_semaphores);
+	if (renderer->waylib_frame_semaphore != VK_NULL_HANDLE) {
+		vkDestroySemaphore(renderer->dev->dev, renderer->waylib_frame_semaphore, NULL);
+	}
+
 	// stage.cb automatically freed with command pool
 	struct wlr_vk_shared_buffer *buf, *tmp_buf;
 	wl_list_for_each_safe(buf, tmp_buf, &renderer->stage.buffers, link) {
@@ -2683,6 +2850,7 @@ struct wlr_renderer *vulkan_renderer_create_for_device(struct wlr_vk_device *dev
 	wl_list_init(&renderer->render_buffers);
 	wl_list_init(&renderer->color_transforms);
 	wl_list_init(&renderer->pipeline_layouts);
+	wl_array_init(&renderer->waylib_wait_semaphores);
 
 	renderer->wlr_renderer.color_encodings =
 		WLR_COLOR_ENCODING_BT601 |
@@ -42,7 +42,7 @@ Item {
         }
     }
 
-    ShaderEffectSource {
+    WindowSnapshot {
         id: backgroundEffect
 
         readonly property real xScale: root.width / surface.width
@@ -58,7 +58,7 @@ Item {
         y: sourceRect.y * yScale
     }
 
-    ShaderEffectSource {
+    WindowSnapshot {
         id: frontEffect
 
         readonly property real xScale: root.width / fromGeometry.width
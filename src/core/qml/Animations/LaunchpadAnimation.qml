@@ -81,7 +81,7 @@ Item {
         }
     ]
 
-    ShaderEffectSource {
+    WindowSnapshot {
         id: effect
         live: root.direction === LaunchpadAnimation.Direction.Show
         hideSource: true
@@ -53,7 +53,7 @@ Item {
         }
     }
 
-    ShaderEffectSource {
+    WindowSnapshot {
         id: effect
         live: root.direction === LayerShellAnimation.Direction.Show
         hideSource: true
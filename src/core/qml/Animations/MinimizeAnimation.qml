@@ -110,7 +110,7 @@ Item {
             cornerRadius: root.target.radius
         }
 
-        ShaderEffectSource {
+        WindowSnapshot {
             anchors.fill: parent
             live: false
             hideSource: true
@@ -52,7 +52,7 @@ Item {
         }
     }
 
-    ShaderEffectSource {
+    WindowSnapshot {
         id: effect
         // 50 > shadow width
         x: -50
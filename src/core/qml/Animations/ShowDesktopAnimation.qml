@@ -43,7 +43,7 @@ Item {
             cornerRadius: root.target.radius
         }
 
-        ShaderEffectSource {
+        WindowSnapshot {
             anchors.fill: parent
             live: false
             hideSource: true
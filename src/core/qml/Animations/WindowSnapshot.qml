@@ -0,0 +1,79 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+import QtQuick
+import Treeland
+import Waylib.Server
+
+// A ShaderEffectSource for window animations. Windows without decoration, title bar
+// and blur are nothing but client buffers, so they are shown by a SurfaceSnapshot that
+// samples those buffers directly instead of rendering the window offscreen first.
+Item {
+    id: root
+
+    property Item sourceItem
+    property rect sourceRect
+    property bool live: true
+    property bool hideSource: false
+
+    readonly property bool useSurfaceSnapshot: snapshotKind.useSurfaceSnapshot
+
+    signal scheduledUpdateCompleted
+
+    function scheduleUpdate() {
+        if (loader.item)
+            loader.item.scheduleUpdate();
+    }
+
+    // The kind of capture is picked once, for the window the animation starts with.
+    // Animations clear sourceItem when they stop, and a window's decoration may change
+    // while it animates, neither may swap the capture under the running animation.
+    function pickSnapshotKind() {
+        if (snapshotKind.picked || !sourceItem)
+            return;
+        const wrapper = sourceItem as SurfaceWrapper;
+        snapshotKind.useSurfaceSnapshot = wrapper !== null
+            && !wrapper.visibleDecoration && wrapper.noTitleBar && !wrapper.blur;
+        snapshotKind.picked = true;
+    }
+
+    onSourceItemChanged: pickSnapshotKind()
+    Component.onCompleted: pickSnapshotKind()
+
+    QtObject {
+        id: snapshotKind
+        property bool picked: false
+        property bool useSurfaceSnapshot: false
+    }
+
+    Loader {
+        id: loader
+        anchors.fill: parent
+        active: snapshotKind.picked
+        sourceComponent: root.useSurfaceSnapshot ? surfaceSnapshot : shaderEffectSource
+    }
+
+    Component {
+        id: surfaceSnapshot
+
+        SurfaceSnapshot {
+            sourceItem: root.sourceItem
+            sourceRect: root.sourceRect
+            live: root.live
+            hideSource: root.hideSource
+            onScheduledUpdateCompleted: root.scheduledUpdateCompleted()
+        }
+    }
+
+    Component {
+        id: shaderEffectSource
+
+        ShaderEffectSource {
+            sourceItem: root.sourceItem
+            sourceRect: root.sourceRect
+            live: root.live
+            hideSource: root.hideSource
+            onScheduledUpdateCompleted: root.scheduledUpdateCompleted()
+        }
+    }
+}
@@ -4,6 +4,7 @@
 import QtQuick
 import QtQuick.Controls
 import Waylib.Server 1.0
+import Treeland
 
 // Pre-launch splash QML item that can be shown before an application's main window appears.
 Item {
@@ -12,8 +13,18 @@ Item {
     required property real initialRadius
     required property var iconBuffer
     required property color backgroundColor
+    // The last frame of the app's previous run, empty if there is none
+    required property url snapshot
+    readonly property bool hasSnapshot: snapshotImage.status === Image.Ready
     readonly property bool isLightBackground: backgroundColor.hslLightness >= 0.5
 
+    signal fadeOutFinished()
+
+    // Reveals the real surface below, the splash is stacked above it by SurfaceWrapper
+    function fadeOut() {
+        fadeOutAnimation.start()
+    }
+
     // Fill the entire parent (SurfaceWrapper)
     anchors.fill: parent
 
@@ -27,6 +38,7 @@ Item {
         Column {
             id: contentColumn
             anchors.centerIn: parent
+            visible: !splash.hasSnapshot
             spacing: 12
 
             Item {
@@ -67,4 +79,31 @@ Item {
             }
         }
     }
+
+    // Decoded off the main thread, the icon is shown until it's ready
+    Image {
+        id: snapshotImage
+        anchors.fill: parent
+        asynchronous: true
+        cache: false
+        source: splash.snapshot
+    }
+
+    TRadiusEffect {
+        anchors.fill: parent
+        visible: splash.hasSnapshot
+        sourceItem: snapshotImage
+        hideSource: true
+        radius: initialRadius
+    }
+
+    NumberAnimation {
+        id: fadeOutAnimation
+        target: splash
+        property: "opacity"
+        to: 0
+        duration: 200
+        easing.type: Easing.OutQuad
+        onFinished: splash.fadeOutFinished()
+    }
 }
@@ -175,6 +175,9 @@ OutputItem {
 
             Connections {
                 target: Helper
+                // Whether to resume playing once the output is no longer idle.
+                property bool playBeforeIdle: false
+
                 function onLaunchpadMappedChanged(output, mapped) {
                     if (output !== rootOutputItem.output) {
                         return;
@@ -198,9 +201,27 @@ OutputItem {
                         return;
                     }
 
+                    playBeforeIdle = false
                     wallpaper.play = false
                     wallpaper.state = showAnimation ? "ScaleTo1.2" : "ScaleWithoutAnimation"
                 }
+
+                function onOutputIdleChanged(output, idle) {
+                    if (output !== rootOutputItem.output) {
+                        return;
+                    }
+
+                    // Nothing animates on an idle output, so it stops asking for frames.
+                    if (idle) {
+                        if (wallpaper.play) {
+                            playBeforeIdle = true
+                            wallpaper.play = false
+                        }
+                    } else if (playBeforeIdle) {
+                        playBeforeIdle = false
+                        wallpaper.play = true
+                    }
+                }
             }
         }
     }
@@ -35,6 +35,18 @@ Item {
         live: root.surface && !(root.surface.flags & SurfaceItem.NonLive)
         smooth: root.surface?.smooth ?? true
 
+        // A fullscreen client (e.g. a video player) can be put on an overlay plane as-is,
+        // waylib falls back to GPU composition whenever its buffer isn't suitable.
+        OutputLayer.enabled: !!root.wrapper
+                             && root.wrapper.surfaceState === SurfaceWrapper.State.Fullscreen
+                             && !root.wrapper.blur
+                             && !effectLoader.active
+                             && !!root.wrapper.ownsOutput
+        OutputLayer.outputs: root.wrapper?.ownsOutput ? [root.wrapper.ownsOutput.screenViewport] : []
+        OutputLayer.flags: OutputLayer.DirectScanout
+        // keep the cursor layer on top
+        OutputLayer.z: -1
+
         onDevicePixelRatioChanged: {
             if (wrapper) {
                 wrapper.updateSurfaceSizeRatio()
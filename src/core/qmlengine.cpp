@@ -282,7 +282,8 @@ QQuickItem *QmlEngine::createFpsDisplay(QQuickItem *parent)
 QQuickItem *QmlEngine::createPrelaunchSplash(QQuickItem *parent,
                                              qreal initialRadius,
                                              wlr_buffer *iconBuffer,
-                                             const QColor &backgroundColor)
+                                             const QColor &backgroundColor,
+                                             const QUrl &snapshot)
 {
     return createComponent(prelaunchSplashComponent,
                            parent,
@@ -290,5 +291,6 @@ QQuickItem *QmlEngine::createPrelaunchSplash(QQuickItem *parent,
                                { "initialRadius", QVariant::fromValue(initialRadius) },
                                { "iconBuffer", QVariant::fromValue(iconBuffer) },
                                { "backgroundColor", QVariant::fromValue(backgroundColor) },
+                               { "snapshot", QVariant::fromValue(snapshot) },
                            });
 }
@@ -71,7 +71,8 @@ public:
     QQuickItem *createPrelaunchSplash(QQuickItem *parent,
                                       qreal initialRadius,
                                       wlr_buffer *iconBuffer,
-                                      const QColor &backgroundColor);
+                                      const QColor &backgroundColor,
+                                      const QUrl &snapshot = QUrl());
 
     QQmlComponent *surfaceContentComponent()
     {
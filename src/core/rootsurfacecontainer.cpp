@@ -25,6 +25,8 @@
 #include <QPointer>
 #include <QQuickWindow>
 
+#include <utility>
+
 WAYLIB_SERVER_USE_NAMESPACE
 
 namespace {
@@ -78,12 +80,20 @@ void RootSurfaceContainer::init(WServer *server)
     m_outputLayout = new WOutputLayout(server);
     m_cursor->setLayout(m_outputLayout);
     connect(m_outputLayout, &WOutputLayout::implicitWidthChanged, this, [this] {
+        if (m_outputLayoutChangeDepth > 0) {
+            m_outputLayoutDirty = true;
+            return;
+        }
         const auto width = m_outputLayout->implicitWidth();
         window()->setWidth(width);
         setWidth(width);
     });
 
     connect(m_outputLayout, &WOutputLayout::implicitHeightChanged, this, [this] {
+        if (m_outputLayoutChangeDepth > 0) {
+            m_outputLayoutDirty = true;
+            return;
+        }
         const auto height = m_outputLayout->implicitHeight();
         window()->setHeight(height);
         setHeight(height);
@@ -95,15 +105,11 @@ void RootSurfaceContainer::init(WServer *server)
     m_outputLayoutListenerOwner = std::make_unique<WListenerOwner>();
     m_outputLayout->listeners(m_outputLayoutListenerOwner.get())->add(
         &m_outputLayout->handle()->events.change, this, [this] {
-        for (auto output : std::as_const(outputs())) {
-            output->updatePositionFromLayout();
+        if (m_outputLayoutChangeDepth > 0) {
+            m_outputLayoutDirty = true;
+            return;
         }
-        ensureCursorVisible();
-
-        // for (auto s : m_surfaceContainer->surfaces()) {
-        //     ensureSurfaceNormalPositionValid(s);
-        //     updateSurfaceOutputs(s);
-        // }
+        updateFromOutputLayout();
     });
 
     m_dragSurfaceItem = new WSurfaceItem(window()->contentItem());
@@ -428,6 +434,39 @@ const QList<Output *> &RootSurfaceContainer::outputs() const
     return m_outputModel->objects();
 }
 
+void RootSurfaceContainer::beginOutputLayoutChange()
+{
+    ++m_outputLayoutChangeDepth;
+}
+
+void RootSurfaceContainer::endOutputLayoutChange()
+{
+    Q_ASSERT(m_outputLayoutChangeDepth > 0);
+    if (--m_outputLayoutChangeDepth > 0 || !std::exchange(m_outputLayoutDirty, false))
+        return;
+
+    const auto width = m_outputLayout->implicitWidth();
+    const auto height = m_outputLayout->implicitHeight();
+    window()->setWidth(width);
+    window()->setHeight(height);
+    setWidth(width);
+    setHeight(height);
+    updateFromOutputLayout();
+}
+
+void RootSurfaceContainer::updateFromOutputLayout()
+{
+    for (auto output : std::as_const(outputs())) {
+        output->updatePositionFromLayout();
+    }
+    ensureCursorVisible();
+
+    // for (auto s : m_surfaceContainer->surfaces()) {
+    //     ensureSurfaceNormalPositionValid(s);
+    //     updateSurfaceOutputs(s);
+    // }
+}
+
 void RootSurfaceContainer::ensureCursorVisible()
 {
     const auto cursorPos = m_cursor->position();
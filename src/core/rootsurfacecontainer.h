@@ -64,6 +64,10 @@ public:
 
     void init(WServer *server);
 
+    // Between these calls output layout changes are applied once, at the last end.
+    void beginOutputLayoutChange();
+    void endOutputLayoutChange();
+
     SurfaceWrapper *getSurface(WSurface *surface) const;
     SurfaceWrapper *getSurface(WToplevelSurface *surface) const;
     void destroyForSurface(SurfaceWrapper *wrapper);
@@ -137,6 +141,7 @@ private:
                                   [[maybe_unused]] SurfaceWrapper::State oldState) override;
 
     void ensureCursorVisible();
+    void updateFromOutputLayout();
     void updateSurfaceOutputs(SurfaceWrapper *surface);
     QQuickItem *ensureEdgeTilePreview();
     void onSeatAdded(WSeat *seat);
@@ -147,6 +152,8 @@ private:
 
     WOutputLayout *m_outputLayout = nullptr;
     std::unique_ptr<WAYLIB_SERVER_NAMESPACE::WListenerOwner> m_outputLayoutListenerOwner;
+    int m_outputLayoutChangeDepth = 0;
+    bool m_outputLayoutDirty = false;
     OutputListModel *m_outputModel = nullptr;
     QPointer<Output> m_primaryOutput;
     WCursor *m_cursor = nullptr;
@@ -6,6 +6,7 @@
 #include "common/treelandlogging.h"
 #include "core/imcandidatepanelmanager.h"
 #include "core/qmlengine.h"
+#include "core/splashsnapshotcache.h"
 #include "core/windowconfigstore.h"
 #include "layersurfacecontainer.h"
 #include "modules/app-id-resolver/appidresolver.h"
@@ -71,6 +72,17 @@ ShellHandler::ShellHandler(RootSurfaceContainer *rootContainer, WServer *server)
     , m_privilegedOverlayContainer(new SurfaceContainer(rootContainer))
     , m_windowConfigStore(new WindowConfigStore(this))
 {
+    auto *globalConfig = Helper::instance()->globalConfig();
+    m_splashSnapshotCache =
+        new SplashSnapshotCache(globalConfig->splashSnapshotCacheSize() * 1024 * 1024, this);
+    connect(globalConfig,
+            &TreelandConfig::splashSnapshotCacheSizeChanged,
+            m_splashSnapshotCache,
+            [this, globalConfig] {
+                m_splashSnapshotCache->setMaxBytes(globalConfig->splashSnapshotCacheSize() * 1024
+                                                   * 1024);
+            });
+
     m_treelandForeignToplevel = server->attach<ForeignToplevelManagerInterfaceV1>();
     Q_ASSERT(m_treelandForeignToplevel);
     qmlRegisterSingletonInstance<ForeignToplevelManagerInterfaceV1>(
@@ -309,13 +321,17 @@ void ShellHandler::createPrelaunchSplash(const QString &appId,
     const qlonglong effectiveType =
         splashThemeType == 0 ? Helper::instance()->config()->windowThemeType() : splashThemeType;
     const QColor splashColor = effectiveType == 1 ? QColor(lightPalette) : QColor(darkPalette);
+    const QUrl snapshot = m_windowConfigStore->splashSnapshotEnabled(appId)
+        ? m_splashSnapshotCache->snapshotFor(appId)
+        : QUrl();
 
     auto *wrapper = new SurfaceWrapper(Helper::instance()->qmlEngine(),
                                        nullptr,
                                        lastSize,
                                        appId,
                                        iconBuffer,
-                                       splashColor);
+                                       splashColor,
+                                       snapshot);
     if (iconBuffer) {
         wlr_buffer_unlock(iconBuffer);
     }
@@ -371,6 +387,25 @@ void ShellHandler::createPrelaunchSplash(const QString &appId,
     }
 }
 
+void ShellHandler::storeSplashSnapshot(SurfaceWrapper *wrapper)
+{
+    const QString appId = wrapper->appId();
+    if (appId.isEmpty() || !wrapper->surfaceItem())
+        return;
+
+    if (!m_windowConfigStore->splashSnapshotEnabled(appId)) {
+        // Don't keep the snapshot of an app that opted out since.
+        m_splashSnapshotCache->remove(appId);
+        return;
+    }
+
+    // A minimized window's last frame isn't what the user remembers of it.
+    if (wrapper->isMinimized())
+        return;
+
+    m_splashSnapshotCache->store(appId, wrapper->surfaceItem());
+}
+
 void ShellHandler::handlePrelaunchSplashClosed(const QString &appId, const QString &instanceId)
 {
     Q_UNUSED(instanceId); // TODO: will be provided by AM DBus in future
@@ -714,6 +749,7 @@ void ShellHandler::onXdgToplevelSurfaceRemoved(WXdgToplevelSurface *surface)
             m_windowConfigStore->saveLastSize(wrapper->appId(), s);
         }
     }
+    storeSplashSnapshot(wrapper);
     Q_EMIT surfaceWrapperAboutToRemove(wrapper);
     m_rootSurfaceContainer->destroyForSurface(wrapper);
 }
@@ -837,6 +873,7 @@ void ShellHandler::onXWaylandSurfaceAdded(WXWaylandSurface *surface)
                 m_windowConfigStore->saveLastSize(wrapper->appId(), s);
             }
         }
+        storeSplashSnapshot(wrapper);
         Q_EMIT surfaceWrapperAboutToRemove(wrapper);
         m_rootSurfaceContainer->destroyForSurface(wrapper);
     });
@@ -59,6 +59,7 @@ QT_END_NAMESPACE
 
 class AppIdResolverManager; // forward declare new protocol manager
 class WindowConfigStore;    // forward declare config store
+class SplashSnapshotCache;
 class TreelandWallpaperShellInterfaceV1;
 class TreelandWallpaperSurfaceInterfaceV1;
 
@@ -146,6 +147,8 @@ private:
                                         const QString &instanceId,
                                         wlr_buffer *iconBuffer);
     void handlePrelaunchSplashClosed(const QString &appId, const QString &instanceId);
+    // Keeps the last frame of a closing toplevel for its next prelaunch splash
+    void storeSplashSnapshot(SurfaceWrapper *wrapper);
     void createPrelaunchSplash(const QString &appId,
                                const QString &instanceId,
                                wlr_buffer *iconBuffer,
@@ -207,4 +210,5 @@ private:
     // New protocol based app id resolver (optional, may be null if module not loaded)
     AppIdResolverManager *m_appIdResolverManager = nullptr;
     WindowConfigStore *m_windowConfigStore = nullptr;
+    SplashSnapshotCache *m_splashSnapshotCache = nullptr;
 };
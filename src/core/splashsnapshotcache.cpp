@@ -0,0 +1,197 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "core/splashsnapshotcache.h"
+
+#include "common/treelandlogging.h"
+
+#include <wsurfaceitem.h>
+#include <wtextureproviderprovider.h>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+// A splash only needs to hint the app's layout, a small image keeps the cache and the
+// decoding cheap.
+static constexpr int MaxSnapshotEdge = 640;
+static constexpr int JpegQuality = 80;
+
+SplashSnapshotCache::SplashSnapshotCache(qint64 maxBytes, QObject *parent)
+    : QObject(parent)
+    , m_directory(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                  + QStringLiteral("/treeland/splash-snapshots"))
+    , m_maxBytes(maxBytes)
+{
+    QDir dir(m_directory);
+    if (!dir.mkpath(QStringLiteral("."))) {
+        qCWarning(lcTlPrelaunchSplash) << "Failed to create splash snapshot directory" << m_directory;
+        return;
+    }
+
+    const auto files = dir.entryInfoList({ QStringLiteral("*.jpg") }, QDir::Files);
+    for (const auto &info : files) {
+        m_entries.insert(info.fileName(),
+                         { info.size(), info.lastModified().toMSecsSinceEpoch() });
+        m_totalBytes += info.size();
+    }
+
+    evict();
+}
+
+void SplashSnapshotCache::setMaxBytes(qint64 maxBytes)
+{
+    if (m_maxBytes == maxBytes)
+        return;
+
+    m_maxBytes = maxBytes;
+    evict();
+}
+
+void SplashSnapshotCache::store(const QString &appId, WSurfaceItem *surfaceItem)
+{
+    if (appId.isEmpty() || !surfaceItem || m_maxBytes <= 0)
+        return;
+
+    auto content = surfaceItem->findItemContent();
+    if (!content)
+        return;
+
+    // Only the part inside the window geometry, without client side shadows.
+    QRectF crop(0, 0, 1, 1);
+    if (content->width() > 0 && content->height() > 0) {
+        const QRectF rect = content->mapRectFromItem(surfaceItem, surfaceItem->boundingRect())
+                                .intersected(content->boundingRect());
+        crop = QRectF(rect.x() / content->width(),
+                      rect.y() / content->height(),
+                      rect.width() / content->width(),
+                      rect.height() / content->height());
+    }
+
+    const QString filePath = m_directory + QLatin1Char('/') + fileNameFor(appId);
+    // Owned by the content, a grab of a destroyed content is dropped.
+    const QPointer<WTextureCapturer> capturer = new WTextureCapturer(content, content);
+    capturer->grabToImage()
+        .then(this,
+              [this, capturer, crop, filePath](QImage image) {
+                  if (capturer)
+                      capturer->deleteLater();
+
+                  QThreadPool::globalInstance()->start([guard = QPointer(this),
+                                                        image = std::move(image),
+                                                        crop,
+                                                        filePath] {
+                      const QRect pixelCrop(qRound(crop.x() * image.width()),
+                                            qRound(crop.y() * image.height()),
+                                            qRound(crop.width() * image.width()),
+                                            qRound(crop.height() * image.height()));
+                      QImage snapshot = image.copy(pixelCrop);
+                      if (snapshot.isNull())
+                          return;
+                      if (qMax(snapshot.width(), snapshot.height()) > MaxSnapshotEdge) {
+                          snapshot = snapshot.scaled(QSize(MaxSnapshotEdge, MaxSnapshotEdge),
+                                                     Qt::KeepAspectRatio,
+                                                     Qt::SmoothTransformation);
+                      }
+                      // JPEG has no alpha channel.
+                      snapshot.convertTo(QImage::Format_RGB888);
+
+                      // The splash may be reading the old file, replace it atomically.
+                      QSaveFile file(filePath);
+                      if (!file.open(QIODevice::WriteOnly) || !snapshot.save(&file, "JPEG", JpegQuality)
+                          || !file.commit()) {
+                          qCWarning(lcTlPrelaunchSplash)
+                              << "Failed to save splash snapshot" << filePath << file.errorString();
+                          return;
+                      }
+
+                      const QFileInfo info(filePath);
+                      if (guard) {
+                          QMetaObject::invokeMethod(guard.data(), [guard, info] {
+                              if (guard)
+                                  guard->onStored(info.fileName(), info.size());
+                          });
+                      }
+                  });
+              })
+        .onFailed(this, [capturer, appId](const std::exception &e) {
+            if (capturer)
+                capturer->deleteLater();
+            qCWarning(lcTlPrelaunchSplash) << "Failed to capture splash snapshot for" << appId
+                                           << e.what();
+        });
+}
+
+QUrl SplashSnapshotCache::snapshotFor(const QString &appId)
+{
+    const QString fileName = fileNameFor(appId);
+    auto it = m_entries.find(fileName);
+    if (it == m_entries.end())
+        return {};
+
+    const QString filePath = m_directory + QLatin1Char('/') + fileName;
+    const QDateTime now = QDateTime::currentDateTime();
+    it->lastUsed = now.toMSecsSinceEpoch();
+    // Persist the use for the eviction order after a restart.
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(now, QFileDevice::FileModificationTime);
+
+    return QUrl::fromLocalFile(filePath);
+}
+
+void SplashSnapshotCache::remove(const QString &appId)
+{
+    const QString fileName = fileNameFor(appId);
+    auto it = m_entries.find(fileName);
+    if (it == m_entries.end())
+        return;
+
+    m_totalBytes -= it->size;
+    m_entries.erase(it);
+    QFile::remove(m_directory + QLatin1Char('/') + fileName);
+}
+
+QString SplashSnapshotCache::fileNameFor(const QString &appId) const
+{
+    return QString::fromLatin1(
+               QCryptographicHash::hash(appId.toUtf8(), QCryptographicHash::Sha1).toHex())
+        + QStringLiteral(".jpg");
+}
+
+void SplashSnapshotCache::onStored(const QString &fileName, qint64 size)
+{
+    Entry &entry = m_entries[fileName];
+    m_totalBytes += size - entry.size;
+    entry.size = size;
+    entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+
+    qCDebug(lcTlPrelaunchSplash) << "Stored splash snapshot" << fileName << size
+                                 << "bytes, cache size" << m_totalBytes;
+    evict();
+}
+
+void SplashSnapshotCache::evict()
+{
+    while (m_totalBytes > m_maxBytes && !m_entries.isEmpty()) {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->lastUsed < oldest->lastUsed)
+                oldest = it;
+        }
+
+        qCDebug(lcTlPrelaunchSplash) << "Evict splash snapshot" << oldest.key();
+        QFile::remove(m_directory + QLatin1Char('/') + oldest.key());
+        m_totalBytes -= oldest->size;
+        m_entries.erase(oldest);
+    }
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#pragma once
+
+#include <wglobal.h>
+
+#include <QHash>
+#include <QObject>
+#include <QUrl>
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+class WSurfaceItem;
+WAYLIB_SERVER_END_NAMESPACE
+
+// Downscaled captures of the last frame of closed toplevels, shown as the prelaunch splash
+// on the app's next launch. Stored as JPEG files in the user's cache directory, the least
+// recently used ones are removed when the total size goes beyond maxBytes.
+class SplashSnapshotCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SplashSnapshotCache(qint64 maxBytes, QObject *parent = nullptr);
+
+    void setMaxBytes(qint64 maxBytes);
+
+    // Captures the item's current buffer, scaling and encoding run on a worker thread.
+    void store(const QString &appId, WAYLIB_SERVER_NAMESPACE::WSurfaceItem *surfaceItem);
+    // An empty url if the app has no snapshot, marks the snapshot as used otherwise.
+    QUrl snapshotFor(const QString &appId);
+    void remove(const QString &appId);
+
+private:
+    struct Entry
+    {
+        qint64 size = 0;
+        qint64 lastUsed = 0;
+    };
+
+    QString fileNameFor(const QString &appId) const;
+    void onStored(const QString &fileName, qint64 size);
+    void evict();
+
+    QString m_directory;
+    qint64 m_maxBytes = 0;
+    qint64 m_totalBytes = 0;
+    QHash<QString, Entry> m_entries;
+};
@@ -37,6 +37,7 @@
 #include <QDir>
 #include <QStandardPaths>
 
+#include <algorithm>
 #include <memory>
 #include <pwd.h>
 #include <sys/socket.h>
@@ -247,6 +248,19 @@ public:
         }
     }
 
+    // Compositor1 is on the system bus and everyone may call it, only the user of
+    // the active session can change its outputs.
+    bool callerIsActiveSession(const QDBusConnection &connection, const QDBusMessage &message) const
+    {
+        auto uid = connection.interface()->serviceUid(message.service());
+        auto session = helper->sessionManager()->sessionForUid(uid);
+        if (!session || session != helper->sessionManager()->activeSession().lock()) {
+            qCWarning(lcTlDBus) << "Rejected output request from uid" << uid.value();
+            return false;
+        }
+        return true;
+    }
+
 private:
     Treeland *q_ptr;
 #ifndef DISABLE_DDM
@@ -279,6 +293,16 @@ class Compositor1Adaptor: public QDBusAbstractAdaptor
                 "      <arg direction=\"out\" type=\"s\" name=\"result\"/>\n"
                 "      <arg direction=\"out\" type=\"ay\" name=\"auth\"/>\n"
                 "    </method>\n"
+                "    <method name=\"CreateVirtualOutput\">\n"
+                "      <arg direction=\"in\" type=\"u\" name=\"width\"/>\n"
+                "      <arg direction=\"in\" type=\"u\" name=\"height\"/>\n"
+                "      <arg direction=\"in\" type=\"u\" name=\"refreshMilliHz\"/>\n"
+                "      <arg direction=\"out\" type=\"s\" name=\"name\"/>\n"
+                "    </method>\n"
+                "    <method name=\"RemoveVirtualOutput\">\n"
+                "      <arg direction=\"in\" type=\"s\" name=\"name\"/>\n"
+                "      <arg direction=\"out\" type=\"b\" name=\"result\"/>\n"
+                "    </method>\n"
                 "    <signal name=\"SessionChanged\"/>\n"
                 "  </interface>\n"
                 "")
@@ -304,6 +328,16 @@ public Q_SLOTS: // METHODS
         parent()->XWaylandName();
     }
 
+    QString CreateVirtualOutput(uint width, uint height, uint refreshMilliHz)
+    {
+        return parent()->CreateVirtualOutput(width, height, refreshMilliHz);
+    }
+
+    bool RemoveVirtualOutput(const QString &name)
+    {
+        return parent()->RemoveVirtualOutput(name);
+    }
+
 Q_SIGNALS: // SIGNALS
     void SessionChanged();
 };
@@ -509,6 +543,36 @@ void Treeland::XWaylandName()
     return;
 }
 
+QString Treeland::CreateVirtualOutput(uint width, uint height, uint refreshMilliHz)
+{
+    Q_D(Treeland);
+
+    if (!d->callerIsActiveSession(connection(), message())) {
+        sendErrorReply(QDBusError::AccessDenied, "Only the active session can create virtual outputs");
+        return {};
+    }
+
+    const QSize size(int(std::min(width, uint(Helper::MaxVirtualOutputSize))),
+                     int(std::min(height, uint(Helper::MaxVirtualOutputSize))));
+    const int refresh = int(std::min(refreshMilliHz, uint(Helper::MaxVirtualOutputRefresh)));
+    const QString name = d->helper->createVirtualOutput(size, refresh);
+    if (name.isEmpty())
+        sendErrorReply(QDBusError::InvalidArgs, "Failed to create virtual output");
+    return name;
+}
+
+bool Treeland::RemoveVirtualOutput(const QString &name)
+{
+    Q_D(Treeland);
+
+    if (!d->callerIsActiveSession(connection(), message())) {
+        sendErrorReply(QDBusError::AccessDenied, "Only the active session can remove virtual outputs");
+        return false;
+    }
+
+    return d->helper->removeVirtualOutput(name);
+}
+
 void Treeland::quit()
 {
     // make sure all deleted before app exit
@@ -48,6 +48,8 @@ Q_SIGNALS:
 public Q_SLOTS:
     bool ActivateWayland(QDBusUnixFileDescriptor fd);
     void XWaylandName();
+    QString CreateVirtualOutput(uint width, uint height, uint refreshMilliHz);
+    bool RemoveVirtualOutput(const QString &name);
 
 private:
     void quit();
@@ -46,7 +46,8 @@ public:
 
 void preInit(int &argc, char *argv[])
 {
-    WLog::init();
+    WLog::init(qEnvironmentVariableIsSet("TREELAND_ASYNC_LOG") ? WLog::Sink::Async
+                                                               : WLog::Sink::Direct);
     DTK_GUI_NAMESPACE::DGuiApplicationHelper::setAttribute(
         DTK_GUI_NAMESPACE::DGuiApplicationHelper::DontSaveApplicationTheme, true);
     WServer::initializeQPA({}, [](const QString &) {
@@ -49,6 +49,16 @@ void WindowConfigStore::saveLastSize(const QString &appId, const QSize &size)
     config->setLastWindowHeight(size.height());
 }
 
+bool WindowConfigStore::splashSnapshotEnabled(const QString &appId) const
+{
+    auto *config = configForApp(appId);
+#if APPCONFIG_DCONFIG_FILE_VERSION_MINOR > 0
+    return config && config->isInitializeSucceeded() && config->enableSplashSnapshot();
+#else
+    return config && config->isInitializeSucceed() && config->enableSplashSnapshot();
+#endif
+}
+
 void WindowConfigStore::withSplashConfigFor(const QString &appId,
                                             QObject *context,
                                             std::function<void(const QSize &size,
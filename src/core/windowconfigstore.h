@@ -19,6 +19,8 @@ public:
     explicit WindowConfigStore(QObject *parent = nullptr);
 
     void saveLastSize(const QString &appId, const QSize &size);
+    // False until the app's config is initialized.
+    bool splashSnapshotEnabled(const QString &appId) const;
 
     void withSplashConfigFor(
         const QString &appId,
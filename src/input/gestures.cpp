@@ -205,9 +205,10 @@ int GestureRecognizer::startSwipeGesture(const QPointF &startPos)
     return startSwipeGesture(1, startPos, GestureRecognizer::Relevant);
 }
 
-void GestureRecognizer::updateSwipeGesture(const QPointF &delta)
+void GestureRecognizer::updateSwipeGesture(const QPointF &delta, quint64 timestamp)
 {
     m_currentDelta += delta;
+    m_swipePredictor.addSample(m_currentDelta, timestamp);
 
     SwipeGesture::Direction direction;
     Axis swipeAxis;
@@ -254,9 +255,14 @@ void GestureRecognizer::updateSwipeGesture(const QPointF &delta)
                                     m_activeSwipeGestures.end());
     }
 
+    QPointF predictedDelta = m_swipePredictor.predicted();
+    // Never predict a swipe back past its start, the direction is already decided.
+    if (QPointF::dotProduct(predictedDelta, m_currentDelta) <= 0)
+        predictedDelta = m_currentDelta;
+
     for (auto &&gesture : std::as_const(m_activeSwipeGestures)) {
-        Q_EMIT gesture->progress(gesture->deltaToProgress(m_currentDelta));
-        Q_EMIT gesture->deltaProgress(m_currentDelta);
+        Q_EMIT gesture->progress(gesture->deltaToProgress(predictedDelta));
+        Q_EMIT gesture->deltaProgress(predictedDelta);
     }
 }
 
@@ -265,6 +271,7 @@ void GestureRecognizer::cancelSwipeGesture()
     cancelSwipeActiveGestures();
     m_currentFingerCount = 0;
     m_currentDelta = QPointF(0, 0);
+    m_swipePredictor.reset();
     m_currentSwipeAxis = Axis::None;
 }
 
@@ -281,6 +288,7 @@ void GestureRecognizer::endSwipeGesture()
     m_activeSwipeGestures.clear();
     m_currentFingerCount = 0;
     m_currentDelta = QPointF(0, 0);
+    m_swipePredictor.reset();
     m_currentSwipeAxis = Axis::None;
 }
 
@@ -291,6 +299,7 @@ void GestureRecognizer::cancelSwipeActiveGestures()
     }
     m_activeSwipeGestures.clear();
     m_currentDelta = QPointF(0, 0);
+    m_swipePredictor.reset();
     m_currentSwipeAxis = Axis::None;
 }
 
@@ -435,6 +444,11 @@ void GestureRecognizer::registerHoldGesture(HoldGesture *gesture)
     m_holdGestures << gesture;
 }
 
+void GestureRecognizer::setPredictionLookahead(int msec)
+{
+    m_swipePredictor.setLookahead(msec);
+}
+
 void GestureRecognizer::setHoldTimeout(int msec)
 {
     m_holdTimeout = msec;
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "input/motionpredictor.h"
+
 #include <QList>
 #include <QMap>
 #include <QObject>
@@ -153,13 +155,15 @@ public:
     int startSwipeGesture(uint fingerCount);
     int startSwipeGesture(const QPointF &startPos);
 
-    void updateSwipeGesture(const QPointF &delta);
+    void updateSwipeGesture(const QPointF &delta, quint64 timestamp);
     void cancelSwipeGesture();
     void endSwipeGesture();
 
     void startHoldGesture(uint fingerCount);
     void endHoldGesture();
     void setHoldTimeout(int msec);
+    // Only the reported progress is predicted, triggering uses the real delta.
+    void setPredictionLookahead(int msec);
 
 private:
     void cancelSwipeActiveGestures();
@@ -173,6 +177,7 @@ private:
     QList<HoldGesture *> m_activeHoldGestures;
 
     QPointF m_currentDelta = QPointF(0, 0);
+    MotionPredictor m_swipePredictor;
     uint m_currentFingerCount = 0;
     int m_holdTimeout = 0;
     GestureRecognizer::Axis m_currentSwipeAxis = GestureRecognizer::None;
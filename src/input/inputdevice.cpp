@@ -432,10 +432,10 @@ void InputDevice::processSwipeStart(uint finger)
     }
 }
 
-void InputDevice::processSwipeUpdate(const QPointF &delta)
+void InputDevice::processSwipeUpdate(const QPointF &delta, quint64 timestamp)
 {
     if (m_touchpadFingerCount >= MIN_SWIPE_FINGERS) {
-        m_touchpadRecognizer->updateSwipeGesture(delta);
+        m_touchpadRecognizer->updateSwipeGesture(delta, timestamp);
     }
 }
 
@@ -472,3 +472,14 @@ void InputDevice::setHoldTimeout(int msec)
 {
     m_touchpadRecognizer->setHoldTimeout(msec);
 }
+
+void InputDevice::setMotionPredictionLookahead(int msec)
+{
+    m_motionPredictionLookahead = msec;
+    m_touchpadRecognizer->setPredictionLookahead(msec);
+}
+
+int InputDevice::motionPredictionLookahead() const
+{
+    return m_motionPredictionLookahead;
+}
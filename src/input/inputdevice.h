@@ -47,7 +47,7 @@ public:
     void unregisterTouchpadHold(HoldGesture *gesture);
 
     void processSwipeStart(uint finger);
-    void processSwipeUpdate(const QPointF &delta);
+    void processSwipeUpdate(const QPointF &delta, quint64 timestamp);
     void processSwipeCancel();
     void processSwipeEnd();
 
@@ -55,6 +55,10 @@ public:
     void processHoldEnd();
     void setHoldTimeout(int msec);
 
+    // How far ahead swipes and touch drags are predicted, 0 disables it.
+    void setMotionPredictionLookahead(int msec);
+    int motionPredictionLookahead() const;
+
 private:
     InputDevice(QObject *parent = nullptr);
     ~InputDevice();
@@ -62,6 +66,7 @@ private:
     static InputDevice *m_instance;
     std::unique_ptr<GestureRecognizer> m_touchpadRecognizer;
     uint m_touchpadFingerCount = 0;
+    int m_motionPredictionLookahead = 0;
 };
 
 bool configAccelSpeed(libinput_device *device, double speed);
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "inputmanager.h"
+#include "common/treelandlogging.h"
 #include "seatuserconfig.hpp"
 #include "treelandconfig.hpp"
 #include "helper.h"
@@ -93,6 +94,22 @@ void InputManager::onConfigInitializeSucceed()
     }
 
     InputDevice::instance()->setHoldTimeout(m_seatDConfig->touchpadHoldTimeoutMs());
+    InputDevice::instance()->setMotionPredictionLookahead(m_seatDConfig->motionPredictionMs());
+    connect(m_seatDConfig, &SeatUserDConfig::motionPredictionMsChanged, this, [this] {
+        InputDevice::instance()->setMotionPredictionLookahead(m_seatDConfig->motionPredictionMs());
+    });
+
+    applyKeymapToSeats();
+    if (seatMgr) {
+        connect(seatMgr,
+                &SeatsManager::seatAdded,
+                this,
+                &InputManager::applyKeymapToSeat,
+                Qt::UniqueConnection);
+    }
+    connect(m_seatDConfig, &SeatUserDConfig::keyboardLayoutChanged, this, &InputManager::applyKeymapToSeats);
+    connect(m_seatDConfig, &SeatUserDConfig::keyboardVariantChanged, this, &InputManager::applyKeymapToSeats);
+    connect(m_seatDConfig, &SeatUserDConfig::keyboardOptionsChanged, this, &InputManager::applyKeymapToSeats);
 
     auto backend = Helper::instance()->backend();
     connect(backend,
@@ -556,6 +573,34 @@ void InputManager::handleKeyboardSettingsApplied(KeyboardSettingsInterfaceV1::Ch
         setNumLockForSeat(interface->wSeat(), interface->numLock());
 }
 
+void InputManager::applyKeymapToSeats()
+{
+    auto *seatManager = Helper::instance()->seatManager();
+    if (!seatManager)
+        return;
+
+    const auto seats = seatManager->seats();
+    for (WSeat *seat : seats)
+        applyKeymapToSeat(seat);
+}
+
+void InputManager::applyKeymapToSeat(WSeat *seat)
+{
+    if (!seat || !m_seatDConfig)
+        return;
+
+    if (!seat->setKeymap(m_seatDConfig->keyboardLayout(),
+                         m_seatDConfig->keyboardVariant(),
+                         m_seatDConfig->keyboardOptions())) {
+        qCWarning(lcTlInputManager) << "Failed to apply keymap to seat" << seat->name();
+    }
+
+    // The xkb state of a new keymap starts without the locked modifiers.
+    auto *globalConfig = Helper::instance()->globalConfig();
+    if (isTreelandConfigInitialized(globalConfig))
+        setNumLockForSeat(seat, globalConfig->keyboardNumLock());
+}
+
 void InputManager::applyNumLockToKeyboards()
 {
     auto *globalConfig = Helper::instance()->globalConfig();
@@ -600,12 +645,17 @@ void InputManager::setNumLockForDevice(WInputDevice *device, bool enabled)
     if (numlock == XKB_MOD_INVALID)
         return;
 
-    xkb_mod_mask_t locked = xkb_state_serialize_mods(wlrKeyboard->xkb_state, XKB_STATE_MODS_LOCKED);
+    const xkb_mod_mask_t currentLocked = xkb_state_serialize_mods(wlrKeyboard->xkb_state, XKB_STATE_MODS_LOCKED);
+    xkb_mod_mask_t locked = currentLocked;
     if (enabled) {
         locked |= (1u << numlock);
     } else {
         locked &= ~(1u << numlock);
     }
+    // Every device of a seat is visited for each hotplugged keyboard, and a modifiers
+    // update of a group member reaches the focused client through the group.
+    if (locked == currentLocked)
+        return;
     const auto depressed = xkb_state_serialize_mods(wlrKeyboard->xkb_state, XKB_STATE_MODS_DEPRESSED);
     const auto latched = xkb_state_serialize_mods(wlrKeyboard->xkb_state, XKB_STATE_MODS_LATCHED);
     const auto group = xkb_state_serialize_layout(wlrKeyboard->xkb_state, XKB_STATE_LAYOUT_EFFECTIVE);
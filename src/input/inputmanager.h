@@ -42,6 +42,8 @@ private Q_SLOTS:
 
 private:
     bool initializeKeyboardSettings(KeyboardSettingsInterfaceV1 *interface);
+    void applyKeymapToSeats();
+    void applyKeymapToSeat(WSeat *seat);
     void applyNumLockToKeyboards();
     static void setNumLockForSeat(WSeat *seat, bool enabled);
 
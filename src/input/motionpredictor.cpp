@@ -0,0 +1,49 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "motionpredictor.h"
+
+#include <QtMath>
+
+// Weight of the newest sample in the velocity, lower is smoother but reacts later.
+static constexpr qreal VelocitySmoothing = 0.5;
+// Samples further apart belong to a finger that stopped, don't extrapolate across them.
+static constexpr quint64 MaxSampleInterval = 50;
+static constexpr int MaxLookahead = 50;
+
+void MotionPredictor::setLookahead(int msec)
+{
+    m_lookahead = qBound(0, msec, MaxLookahead);
+}
+
+void MotionPredictor::reset()
+{
+    m_hasSample = false;
+    m_velocity = QPointF();
+}
+
+void MotionPredictor::addSample(const QPointF &position, quint64 timestamp)
+{
+    if (m_hasSample && timestamp > m_timestamp) {
+        const quint64 interval = timestamp - m_timestamp;
+        if (interval > MaxSampleInterval) {
+            m_velocity = QPointF();
+        } else {
+            const QPointF velocity = (position - m_position) / qreal(interval);
+            // A change of direction would overshoot, follow the new direction at once.
+            if (QPointF::dotProduct(velocity, m_velocity) < 0)
+                m_velocity = velocity;
+            else
+                m_velocity += (velocity - m_velocity) * VelocitySmoothing;
+        }
+    }
+
+    m_hasSample = true;
+    m_position = position;
+    m_timestamp = timestamp;
+}
+
+QPointF MotionPredictor::predicted() const
+{
+    return m_position + m_velocity * m_lookahead;
+}
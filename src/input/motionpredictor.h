@@ -0,0 +1,33 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QPointF>
+
+// Extrapolates a moving position by its smoothed velocity, so compositor driven
+// interactions show where the finger will be when the frame reaches the screen
+// instead of where it was when the event arrived.
+class MotionPredictor
+{
+public:
+    // In milliseconds, 0 disables the prediction.
+    void setLookahead(int msec);
+    int lookahead() const { return m_lookahead; }
+
+    void reset();
+    // timestamp in milliseconds, as the input events carry it.
+    void addSample(const QPointF &position, quint64 timestamp);
+    QPointF predicted() const;
+    // The last sample as it was added.
+    bool hasSample() const { return m_hasSample; }
+    QPointF position() const { return m_position; }
+
+private:
+    int m_lookahead = 0;
+    bool m_hasSample = false;
+    QPointF m_position;
+    quint64 m_timestamp = 0;
+    // Pixels per millisecond.
+    QPointF m_velocity;
+};
@@ -36,11 +36,9 @@ Q_SIGNALS:
 
 private:
     void setOverlapped(bool overlapped);
+    void updateWindowRect();
 
     bool m_overlapped{ false };
-    QRect m_lastRect;
-
-    inline static QRegion region;
 };
 
 class DDEShellHelper : public QObject
@@ -17,7 +17,16 @@ static QList<WindowOverlapCheckerInterface *> s_OverlapCheckers;
 static QList<MultiTaskViewInterface *> s_multiTaskViews;
 static QList<WindowPickerInterface *> s_windowPickers;
 static QList<LockScreenInterface *> s_lockScreens;
-static QMap<WindowOverlapCheckerInterface *, QRect> s_conflictList;
+
+// Each checker keeps the number of windows intersecting its rect, so a window
+// change only tests that window against the (few) checkers.
+struct OverlapCheckerState
+{
+    QRect rect;
+    int overlapCount = 0;
+};
+static QHash<WindowOverlapCheckerInterface *, OverlapCheckerState> s_conflictList;
+static QHash<const QObject *, QRect> s_windowRects;
 
 class DDEShellManagerInterfaceV1Private : public QtWaylandServer::treeland_dde_shell_manager_v1
 {
@@ -608,12 +617,11 @@ WindowOverlapCheckerInterface::~WindowOverlapCheckerInterface() = default;
 void WindowOverlapCheckerInterface::sendOverlapped(bool overlapped)
 {
     if (d->alreadySend && overlapped == d->overlapped) {
-        d->alreadySend = true;
         return;
     }
 
     d->overlapped = overlapped;
-    d->alreadySend = false;
+    d->alreadySend = true;
 
     if (d->overlapped) {
         d->send_enter();
@@ -622,15 +630,28 @@ void WindowOverlapCheckerInterface::sendOverlapped(bool overlapped)
     }
 }
 
-void WindowOverlapCheckerInterface::checkRegionalConflict(const QRegion &region)
+void WindowOverlapCheckerInterface::updateWindowRect(const QObject *window, const QRect &rect)
 {
-    for (auto &&[interface, checkRect] : s_conflictList.asKeyValueRange()) {
-        if (region.intersects(checkRect)) {
-            interface->sendOverlapped(true);
+    const QRect oldRect = s_windowRects.value(window);
+    if (oldRect == rect) {
+        return;
+    }
+
+    if (rect.isEmpty()) {
+        s_windowRects.remove(window);
+    } else {
+        s_windowRects.insert(window, rect);
+    }
+
+    for (auto &&[interface, state] : s_conflictList.asKeyValueRange()) {
+        const int delta = int(rect.intersects(state.rect)) - int(oldRect.intersects(state.rect));
+        if (delta == 0) {
             continue;
-        } else {
-            interface->sendOverlapped(false);
         }
+
+        state.overlapCount += delta;
+        Q_ASSERT(state.overlapCount >= 0);
+        interface->sendOverlapped(state.overlapCount > 0);
     }
 }
 
@@ -682,7 +703,14 @@ void WindowOverlapCheckerInterfacePrivate::update(Resource *resource,
         return;
     }
 
-    s_conflictList.insert(q, checkRect);
+    OverlapCheckerState state{ checkRect };
+    for (const QRect &windowRect : std::as_const(s_windowRects)) {
+        if (windowRect.intersects(checkRect)) {
+            ++state.overlapCount;
+        }
+    }
+    s_conflictList.insert(q, state);
+    q->sendOverlapped(state.overlapCount > 0);
     Q_EMIT q->refresh();
 }
 
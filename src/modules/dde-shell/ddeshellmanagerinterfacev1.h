@@ -140,7 +140,9 @@ public:
     ~WindowOverlapCheckerInterface() override;
     void sendOverlapped(bool overlapped);
 
-    static void checkRegionalConflict(const QRegion &region);
+    // Track the on-screen rect of a window, an empty rect removes it. Checkers
+    // whose overlap state flips are notified immediately.
+    static void updateWindowRect(const QObject *window, const QRect &rect);
 
 Q_SIGNALS:
     void refresh();
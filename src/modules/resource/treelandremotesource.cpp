@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "treelandremotesource.h"
+#include "treelandscenesource.h"
 
 #include "core/rootsurfacecontainer.h"
 #include "core/shellhandler.h"
@@ -30,6 +31,7 @@ TreelandRemoteSource::TreelandRemoteSource(QObject *parent)
     QRemoteObjectHost::setLocalServerOptions(QLocalServer::UserAccessOption);
     host->setHostUrl(QUrl(QStringLiteral("local:org.deepin.dde.treeland.debug")));
     host->enableRemoting(this, QStringLiteral("WindowTree"));
+    host->enableRemoting(new TreelandSceneSource(this), QStringLiteral("Scene"));
 
     if (auto *root = Helper::instance()->rootSurfaceContainer(); root && root->cursor()) {
         updateCursor(root->cursor()->position());
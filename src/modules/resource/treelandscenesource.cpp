@@ -0,0 +1,287 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "treelandscenesource.h"
+
+#include "core/rootsurfacecontainer.h"
+#include "output/output.h"
+#include "seat/helper.h"
+#include "surface/surfacewrapper.h"
+
+#include <woutput.h>
+#include <woutputrenderwindow.h>
+#include <wrenderbufferblitter.h>
+#include <wsurface.h>
+
+#include <wlr_all.h>
+
+#include <QSGNode>
+#include <QSGTextureProvider>
+#include <private/qquickitem_p.h>
+
+#include <utility>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+// About ten seconds at 60 Hz.
+static constexpr std::size_t MaxFrames = 600;
+
+static int countNodes(const QSGNode *node, const QSGMaterial *&lastMaterial, SceneStats &stats)
+{
+    int count = 1;
+    if (node->type() == QSGNode::GeometryNodeType) {
+        stats.setGeometryNodes(stats.geometryNodes() + 1);
+        // The batch renderer merges geometry drawn in a row with compatible materials.
+        const auto *material = static_cast<const QSGGeometryNode *>(node)->activeMaterial();
+        if (material
+            && (!lastMaterial || lastMaterial->type() != material->type()
+                || material->compare(lastMaterial) != 0)) {
+            stats.setBatches(stats.batches() + 1);
+        }
+        lastMaterial = material;
+    }
+
+    for (auto child = node->firstChild(); child; child = child->nextSibling())
+        count += countNodes(child, lastMaterial, stats);
+    return count;
+}
+
+static void addStats(SceneStats &to, const SceneStats &from)
+{
+    to.setNodes(to.nodes() + from.nodes());
+    to.setGeometryNodes(to.geometryNodes() + from.geometryNodes());
+    to.setBatches(to.batches() + from.batches());
+    to.setBlitters(to.blitters() + from.blitters());
+    to.setShaderEffectSources(to.shaderEffectSources() + from.shaderEffectSources());
+    to.setTextureBytes(to.textureBytes() + from.textureBytes());
+    to.setRenderTargetBytes(to.renderTargetBytes() + from.renderTargetBytes());
+}
+
+TreelandSceneSource::TreelandSceneSource(QObject *parent)
+    : SceneInspectorRemoteSource(parent)
+{
+    auto *helper = Helper::instance();
+    if (auto *root = helper->rootSurfaceContainer()) {
+        connect(root, &RootSurfaceContainer::surfaceAdded, this, &TreelandSceneSource::trackSurface);
+        for (auto *surface : std::as_const(root->surfaces()))
+            trackSurface(surface);
+    }
+
+    if (auto *window = helper->window()) {
+        connect(window,
+                &WOutputRenderWindow::renderEnd,
+                this,
+                [this](const QList<QPointer<WOutput>> &committedOutputs) {
+                    QStringList outputs;
+                    for (const auto &output : committedOutputs) {
+                        if (output)
+                            outputs.append(output->name());
+                    }
+                    onRenderEnd(outputs);
+                });
+    }
+}
+
+TreelandSceneSource::~TreelandSceneSource() = default;
+
+void TreelandSceneSource::trackSurface(SurfaceWrapper *surface)
+{
+    // Moving between containers adds the surface again.
+    if (m_trackedSurfaces.contains(surface) || m_waitingSurfaces.contains(surface))
+        return;
+
+    connect(surface, &QObject::destroyed, this, [this, surface] {
+        untrackSurface(surface);
+    });
+
+    if (!surface->surface()) {
+        // A prelaunch splash gets the client's surface with its surface item.
+        m_waitingSurfaces.insert(surface);
+        connect(
+            surface,
+            &SurfaceWrapper::surfaceItemCreated,
+            this,
+            [this, surface] {
+                m_waitingSurfaces.remove(surface);
+                trackCommits(surface);
+            },
+            Qt::SingleShotConnection);
+        return;
+    }
+
+    trackCommits(surface);
+}
+
+void TreelandSceneSource::trackCommits(SurfaceWrapper *surface)
+{
+    auto *wSurface = surface->surface();
+    if (!wSurface)
+        return;
+
+    m_trackedSurfaces.insert(surface);
+    connect(wSurface, &WSurface::commit, this, [this, surface](quint32 committedState) {
+        if ((committedState & WLR_SURFACE_STATE_BUFFER) && m_trackedSurfaces.contains(surface))
+            m_pendingSurfaces.insert(surface);
+    });
+}
+
+void TreelandSceneSource::untrackSurface(SurfaceWrapper *surface)
+{
+    // The address may be reused by the next window.
+    m_trackedSurfaces.remove(surface);
+    m_waitingSurfaces.remove(surface);
+    m_pendingSurfaces.remove(surface);
+    for (auto &frame : m_frames)
+        frame.surfaces.remove(surface);
+}
+
+void TreelandSceneSource::onRenderEnd(const QStringList &outputs)
+{
+    if (outputs.isEmpty())
+        return;
+
+    m_frames.push_back({ outputs, std::exchange(m_pendingSurfaces, {}) });
+    if (m_frames.size() > MaxFrames)
+        m_frames.pop_front();
+}
+
+void TreelandSceneSource::collectItem(Collector &collector, QQuickItem *item, bool stopAtSurfaces)
+{
+    if (!item->isVisible())
+        return;
+
+    auto *d = QQuickItemPrivate::get(item);
+    SceneStats &stats = collector.stats;
+
+    // The nodes the item owns, those of the child items are counted with them.
+    int nodes = 0;
+    nodes += d->itemNodeInstance ? 1 : 0;
+    nodes += d->opacityNode() ? 1 : 0;
+    nodes += d->clipNode() ? 1 : 0;
+    nodes += d->rootNode() ? 1 : 0;
+    nodes += d->groupNode ? 1 : 0;
+    if (d->paintNode)
+        nodes += countNodes(d->paintNode, collector.lastMaterial, stats);
+    stats.setNodes(stats.nodes() + nodes);
+
+    const bool isBlitter = qobject_cast<WRenderBufferBlitter *>(item);
+    const bool isShaderEffectSource = item->inherits("QQuickShaderEffectSource");
+    if (isBlitter)
+        stats.setBlitters(stats.blitters() + 1);
+    if (isShaderEffectSource)
+        stats.setShaderEffectSources(stats.shaderEffectSources() + 1);
+
+    // textureProvider() creates the provider and its texture on the first query, so only
+    // ask the items that were rendered already: they created both in updatePaintNode(),
+    // a layer's effect did for the layer.
+    const bool isLayer = d->layer() && d->layer()->enabled();
+    const bool rendered = d->paintNode || (isLayer && d->itemNodeInstance);
+    if (rendered && item->isTextureProvider()) {
+        auto *provider = item->textureProvider();
+        auto *texture = provider ? provider->texture() : nullptr;
+        if (texture && !collector.textures.contains(texture)) {
+            collector.textures.insert(texture);
+            const QSize size = texture->textureSize();
+            const qint64 bytes = qint64(size.width()) * size.height() * 4;
+            if (isBlitter || isShaderEffectSource || isLayer)
+                stats.setRenderTargetBytes(stats.renderTargetBytes() + bytes);
+            else
+                stats.setTextureBytes(stats.textureBytes() + bytes);
+        }
+    }
+
+    const auto children = d->paintOrderChildItems();
+    for (auto *child : children) {
+        // Other windows are reported on their own.
+        if (stopAtSurfaces && qobject_cast<SurfaceWrapper *>(child))
+            continue;
+        collectItem(collector, child, stopAtSurfaces);
+    }
+}
+
+SurfaceSceneInfo TreelandSceneSource::buildSurfaceInfo(SurfaceWrapper *surface, int frames) const
+{
+    SurfaceSceneInfo info;
+    info.setAppId(surface->appId());
+    if (auto *shellSurface = surface->shellSurface())
+        info.setTitle(shellSurface->property("title").toString());
+    if (auto *output = surface->ownsOutput(); output && output->output())
+        info.setOutput(output->output()->name());
+    info.setType(static_cast<int>(surface->type()));
+    info.setVisible(surface->isVisible());
+
+    int updatedFrames = 0;
+    for (auto it = m_frames.rbegin(); it != m_frames.rend() && it - m_frames.rbegin() < frames; ++it) {
+        if (it->surfaces.contains(surface))
+            ++updatedFrames;
+    }
+    info.setUpdatedFrames(updatedFrames);
+
+    Collector collector;
+    collectItem(collector, surface, true);
+    info.setStats(collector.stats);
+    return info;
+}
+
+SceneInfo TreelandSceneSource::getSceneInfo(int frames)
+{
+    SceneInfo info;
+    frames = qBound(0, frames, int(m_frames.size()));
+    info.setFrames(frames);
+
+    auto *helper = Helper::instance();
+    if (auto *window = helper->window()) {
+        Collector collector;
+        collectItem(collector, window->contentItem(), false);
+        info.setTotal(collector.stats);
+    }
+
+    auto *root = helper->rootSurfaceContainer();
+    if (!root)
+        return info;
+
+    QHash<QString, QList<SurfaceSceneInfo>> surfacesOfOutput;
+    QList<SurfaceSceneInfo> offscreenSurfaces;
+    for (auto *surface : std::as_const(root->surfaces())) {
+        const SurfaceSceneInfo surfaceInfo = buildSurfaceInfo(surface, frames);
+        if (surfaceInfo.output().isEmpty())
+            offscreenSurfaces.append(surfaceInfo);
+        else
+            surfacesOfOutput[surfaceInfo.output()].append(surfaceInfo);
+    }
+    info.setOffscreenSurfaces(offscreenSurfaces);
+
+    QList<OutputSceneInfo> outputs;
+    for (auto *output : std::as_const(root->outputs())) {
+        auto *wOutput = output ? output->output() : nullptr;
+        if (!wOutput)
+            continue;
+
+        OutputSceneInfo outputInfo;
+        outputInfo.setName(wOutput->name());
+        outputInfo.setGeometry(output->geometry());
+        outputInfo.setPixelSize(wOutput->size());
+        outputInfo.setScale(wOutput->scale());
+
+        int renderedFrames = 0;
+        for (auto it = m_frames.rbegin(); it != m_frames.rend() && it - m_frames.rbegin() < frames;
+             ++it) {
+            if (it->outputs.contains(wOutput->name()))
+                ++renderedFrames;
+        }
+        outputInfo.setRenderedFrames(renderedFrames);
+
+        SceneStats stats;
+        const QSize pixelSize = wOutput->size();
+        stats.setRenderTargetBytes(qint64(pixelSize.width()) * pixelSize.height() * 4);
+        const auto surfaces = surfacesOfOutput.value(wOutput->name());
+        for (const auto &surfaceInfo : surfaces)
+            addStats(stats, surfaceInfo.stats());
+        outputInfo.setStats(stats);
+        outputInfo.setSurfaces(surfaces);
+        outputs.append(outputInfo);
+    }
+    info.setOutputs(outputs);
+
+    return info;
+}
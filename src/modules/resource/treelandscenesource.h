@@ -0,0 +1,58 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "rep_treelandscene_source.h"
+
+#include <QSet>
+#include <QStringList>
+
+#include <deque>
+
+class QQuickItem;
+class QSGMaterial;
+class QSGTexture;
+class SurfaceWrapper;
+
+// Reports what each output and window costs the scene graph, to find the item tree
+// responsible when the compositor gets slow without attaching a debugger.
+class TreelandSceneSource : public SceneInspectorRemoteSource
+{
+    Q_OBJECT
+
+public:
+    explicit TreelandSceneSource(QObject *parent = nullptr);
+    ~TreelandSceneSource() override;
+
+    SceneInfo getSceneInfo(int frames) override;
+
+private:
+    struct Frame
+    {
+        QStringList outputs;
+        QSet<const SurfaceWrapper *> surfaces;
+    };
+
+    struct Collector
+    {
+        SceneStats stats;
+        QSet<const QSGTexture *> textures;
+        const QSGMaterial *lastMaterial = nullptr;
+    };
+
+    void trackSurface(SurfaceWrapper *surface);
+    void trackCommits(SurfaceWrapper *surface);
+    void untrackSurface(SurfaceWrapper *surface);
+    void onRenderEnd(const QStringList &outputs);
+
+    SurfaceSceneInfo buildSurfaceInfo(SurfaceWrapper *surface, int frames) const;
+    static void collectItem(Collector &collector, QQuickItem *item, bool stopAtSurfaces);
+
+    // The most recent frame at the back.
+    std::deque<Frame> m_frames;
+    QSet<const SurfaceWrapper *> m_trackedSurfaces;
+    // Added before their client surface exists, like a prelaunch splash.
+    QSet<const SurfaceWrapper *> m_waitingSurfaces;
+    QSet<const SurfaceWrapper *> m_pendingSurfaces;
+};
@@ -250,6 +250,11 @@ bool ShortcutController::dispatchKeyEvent(const QKeyEvent *kevent)
     return true;
 }
 
+bool ShortcutController::hasKeyBinding(QKeyCombination combination) const
+{
+    return m_keyMap.contains(normalizeKeyCombination(combination).toCombined());
+}
+
 Qt::KeyboardModifiers ShortcutController::modifierForAction(ShortcutAction action) const
 {
     auto it = m_actionCombinedMap.find(action);
@@ -67,6 +67,7 @@ public:
 
     void clear();
     bool dispatchKeyEvent(const QKeyEvent *event);
+    bool hasKeyBinding(QKeyCombination combination) const;
     static QKeyCombination normalizeKeyCombination(QKeyCombination combination);
     static bool isValidShortcutCombination(QKeyCombination combination);
     Qt::KeyboardModifiers modifierForAction(ShortcutAction action) const;
@@ -1135,6 +1135,20 @@ static inline void generateGammaLUT(uint32_t colorTemperature,
 
 }
 
+void Output::setIdleDimmed(bool dimmed)
+{
+    if (m_idleDimmed == dimmed)
+        return;
+
+    m_idleDimmed = dimmed;
+    setOutputColor(-1, 0);
+}
+
+bool Output::isIdleDimmed() const
+{
+    return m_idleDimmed;
+}
+
 // TODO: better Chromatic Adaptation algorithms can be implemented when the wlr_color_transform
 // api is available. For now RGB scaling is used due to limitation of gamma LUT table.
 // see: http://www.brucelindbloom.com/index.html?ChromAdaptEval.html
@@ -1157,7 +1171,10 @@ void Output::setOutputColor(qreal brightness,
     bool backlightApplied = false;
 
     if (m_backlight) {
-        qreal backlightBrightness = m_backlight->setBrightness(brightness);
+        // Only a requested brightness is written to the backlight, a re-apply for
+        // the idle dimming keeps the hardware at the configured value.
+        qreal backlightBrightness = brightnessRequested ? m_backlight->setBrightness(brightness)
+                                                        : m_backlight->brightness();
         backlightApplied = qFuzzyCompare(backlightBrightness, brightness);
         if (backlightBrightness != 0)
             brightnessCorrection = qBound(0.0, brightness / backlightBrightness, 1.0);
@@ -1165,6 +1182,11 @@ void Output::setOutputColor(qreal brightness,
         brightnessCorrection = brightness;
     }
 
+    // The idle dimming is only applied through the gamma LUT, it never reaches the
+    // backlight or the saved brightness.
+    if (m_idleDimmed)
+        brightnessCorrection *= IdleDimFactor;
+
     const size_t gammaSize = wlr_output_get_gamma_size(output()->handle());
     if (gammaSize == 0) {
         if (backlightApplied) {
@@ -101,6 +101,10 @@ public:
 
     OutputConfig* config() const;
 
+    // Lowers the brightness while the output is idle, without touching the configured value.
+    void setIdleDimmed(bool dimmed);
+    bool isIdleDimmed() const;
+
     void adjustToOutputBounds(QPointF &pos,
                               const QRectF &normalGeo,
                               const QRectF &outputRect) const;
@@ -179,6 +183,8 @@ private:
 
     std::unique_ptr<Backlight> m_backlight = nullptr;
     OutputConfig *m_config;
+    bool m_idleDimmed = false;
+    static constexpr qreal IdleDimFactor = 0.3;
 };
 
 Q_DECLARE_OPAQUE_POINTER(WAYLIB_SERVER_NAMESPACE::WOutputItem *)
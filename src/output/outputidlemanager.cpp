@@ -0,0 +1,197 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "outputidlemanager.h"
+
+#include "common/treelandlogging.h"
+#include "output/output.h"
+#include "treelandconfig.hpp"
+
+#include <woutput.h>
+
+#include <QTimer>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+OutputIdleManager::OutputIdleManager(TreelandConfig *config, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+{
+    m_clock.start();
+
+    connect(m_config,
+            &TreelandConfig::outputIdleTimeoutChanged,
+            this,
+            &OutputIdleManager::reschedule);
+    connect(m_config,
+            &TreelandConfig::outputIdlePowerOffTimeoutChanged,
+            this,
+            &OutputIdleManager::reschedule);
+}
+
+OutputIdleManager::~OutputIdleManager() = default;
+
+void OutputIdleManager::addOutput(Output *output)
+{
+    Q_ASSERT(!m_entries.contains(output));
+
+    Entry &entry = m_entries[output];
+    entry.timer = new QTimer(this);
+    entry.timer->setSingleShot(true);
+    entry.idleSince = m_clock.elapsed();
+    connect(entry.timer, &QTimer::timeout, this, [this, output] {
+        onTimeout(output);
+    });
+
+    schedule(output, entry);
+}
+
+void OutputIdleManager::removeOutput(Output *output)
+{
+    auto it = m_entries.find(output);
+    if (it == m_entries.end())
+        return;
+
+    if (it->state != State::Active)
+        --m_awayCount;
+    delete it->timer;
+    m_entries.erase(it);
+    m_inhibitedOutputs.remove(output);
+}
+
+OutputIdleManager::State OutputIdleManager::state(Output *output) const
+{
+    auto it = m_entries.constFind(output);
+    return it == m_entries.constEnd() ? State::Active : it->state;
+}
+
+void OutputIdleManager::notifyActivity()
+{
+    m_lastActivity = m_clock.elapsed();
+    if (Q_LIKELY(m_awayCount == 0))
+        return;
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->state == State::Active)
+            continue;
+        setState(it.key(), *it, State::Active);
+        schedule(it.key(), *it);
+    }
+}
+
+void OutputIdleManager::setInhibitedOutputs(const QSet<Output *> &outputs, bool all)
+{
+    if (m_inhibitedOutputs == outputs && m_inhibitAll == all)
+        return;
+
+    m_inhibitedOutputs = outputs;
+    m_inhibitAll = all;
+
+    const qint64 now = m_clock.elapsed();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (isInhibited(it.key())) {
+            if (it->state != State::Active)
+                setState(it.key(), *it, State::Active);
+            it->timer->stop();
+            // Count the idle time from when the inhibitor goes away.
+            it->idleSince = now;
+        } else if (!it->timer->isActive()) {
+            if (it->state == State::Active)
+                it->idleSince = now;
+            schedule(it.key(), *it);
+        }
+    }
+}
+
+bool OutputIdleManager::isInhibited(Output *output) const
+{
+    return m_inhibitAll || m_inhibitedOutputs.contains(output);
+}
+
+// Arms the timer for the next state of the output, the timeouts count from the
+// last activity, so an output left idle for long enough moves on right away.
+void OutputIdleManager::schedule(Output *output, Entry &entry)
+{
+    entry.timer->stop();
+    if (isInhibited(output))
+        return;
+
+    const qint64 deadline = nextDeadline(entry.state,
+                                         qint64(m_config->outputIdleTimeout()) * 1000,
+                                         qint64(m_config->outputIdlePowerOffTimeout()) * 1000);
+    if (deadline <= 0)
+        return;
+
+    const qint64 elapsed = m_clock.elapsed() - std::max(m_lastActivity, entry.idleSince);
+    entry.timer->start(std::max<qint64>(0, deadline - elapsed));
+}
+
+void OutputIdleManager::onTimeout(Output *output)
+{
+    auto it = m_entries.find(output);
+    if (it == m_entries.end())
+        return;
+
+    const qint64 idleTimeout = qint64(m_config->outputIdleTimeout()) * 1000;
+    const qint64 deadline = nextDeadline(it->state,
+                                         idleTimeout,
+                                         qint64(m_config->outputIdlePowerOffTimeout()) * 1000);
+    if (deadline <= 0)
+        return;
+
+    // Input only records its time, see if there was some since the timer started.
+    const qint64 lastActivity = std::max(m_lastActivity, it->idleSince);
+    if (m_clock.elapsed() - lastActivity >= deadline)
+        setState(output, *it, nextState(it->state, idleTimeout));
+
+    schedule(output, *it);
+}
+
+qint64 OutputIdleManager::nextDeadline(State state, qint64 idleTimeout, qint64 powerOffTimeout)
+{
+    switch (state) {
+    case State::Active:
+        return idleTimeout > 0 ? idleTimeout : std::max<qint64>(0, powerOffTimeout);
+    case State::Idle:
+        // A power off timeout shorter than the idle one still waits for idle first.
+        return powerOffTimeout > 0 ? std::max(powerOffTimeout, idleTimeout) : 0;
+    case State::Off:
+        break;
+    }
+    return 0;
+}
+
+OutputIdleManager::State OutputIdleManager::nextState(State state, qint64 idleTimeout)
+{
+    switch (state) {
+    case State::Active:
+        return idleTimeout > 0 ? State::Idle : State::Off;
+    case State::Idle:
+    case State::Off:
+        break;
+    }
+    return State::Off;
+}
+
+void OutputIdleManager::setState(Output *output, Entry &entry, State state)
+{
+    if (entry.state == state)
+        return;
+
+    if (entry.state == State::Active)
+        ++m_awayCount;
+    else if (state == State::Active)
+        --m_awayCount;
+    entry.state = state;
+
+    qCDebug(lcTlOutput) << "Output" << output->output()->name() << "idle state changed to" << state;
+    Q_EMIT stateChanged(output, state);
+}
+
+void OutputIdleManager::reschedule()
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->state != State::Off)
+            schedule(it.key(), *it);
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+
+class Output;
+class QTimer;
+class TreelandConfig;
+
+// Tracks the idle state of each output on its own. An output becomes idle after
+// outputIdleTimeout without input, and is powered off after outputIdlePowerOffTimeout.
+// Input wakes all outputs, an output showing a visible idle inhibitor stays active.
+class OutputIdleManager : public QObject
+{
+    Q_OBJECT
+public:
+    enum class State
+    {
+        Active,
+        Idle,
+        Off,
+    };
+    Q_ENUM(State)
+
+    explicit OutputIdleManager(TreelandConfig *config, QObject *parent = nullptr);
+    ~OutputIdleManager() override;
+
+    void addOutput(Output *output);
+    void removeOutput(Output *output);
+
+    State state(Output *output) const;
+
+    // Cheap enough to call for every input event, it only restarts timers when
+    // some output has to be woken up.
+    void notifyActivity();
+    // The outputs that must not go idle, `all` when idle is inhibited globally.
+    void setInhibitedOutputs(const QSet<Output *> &outputs, bool all);
+
+    // The time without input, in ms, after which an output in `state` moves on to
+    // nextState(), 0 when it stays. Timeouts of 0 are disabled.
+    static qint64 nextDeadline(State state, qint64 idleTimeout, qint64 powerOffTimeout);
+    static State nextState(State state, qint64 idleTimeout);
+
+Q_SIGNALS:
+    void stateChanged(Output *output, OutputIdleManager::State state);
+
+private:
+    struct Entry
+    {
+        QTimer *timer = nullptr;
+        State state = State::Active;
+        // Since when the output is idle, in m_clock time.
+        qint64 idleSince = 0;
+    };
+
+    bool isInhibited(Output *output) const;
+    void schedule(Output *output, Entry &entry);
+    void onTimeout(Output *output);
+    void setState(Output *output, Entry &entry, State state);
+    void reschedule();
+
+    TreelandConfig *m_config;
+    QHash<Output *, Entry> m_entries;
+    QSet<Output *> m_inhibitedOutputs;
+    bool m_inhibitAll = false;
+    QElapsedTimer m_clock;
+    qint64 m_lastActivity = 0;
+    int m_awayCount = 0;
+};
@@ -13,8 +13,7 @@
 #include <woutputitem.h>
 #include <woutputrenderwindow.h>
 
-#include <QtConcurrentMap>
-
+#include <numeric>
 #include <ranges>
 
 WAYLIB_SERVER_USE_NAMESPACE
@@ -126,6 +125,8 @@ void MultitaskviewSurfaceModel::initializeModel()
         return;
     beginResetModel();
     m_data.clear();
+    m_rows.clear();
+    m_rowHeight = 0;
     QList<SurfaceWrapper *> surfaces(workspace()->surfaces());
     surfaces << Helper::instance()->workspace()->showOnAllWorkspaceModel()->surfaces();
     for (const auto &surface : std::as_const(surfaces)) {
@@ -163,6 +164,11 @@ void MultitaskviewSurfaceModel::initializeModel()
                 this,
                 &MultitaskviewSurfaceModel::handleSurfaceStateChanged,
                 Qt::UniqueConnection);
+        connect(surface,
+                &SurfaceWrapper::appIdChanged,
+                this,
+                &MultitaskviewSurfaceModel::updateSameAppIndex,
+                Qt::UniqueConnection);
     }
     std::sort(m_data.begin(),
               m_data.end(),
@@ -170,6 +176,7 @@ void MultitaskviewSurfaceModel::initializeModel()
                   return laterActiveThan(lhs->wrapper, rhs->wrapper);
               });
     doUpdateZOrder(m_data);
+    updateSameAppIndex();
     endResetModel();
     m_modelReady = true;
     Q_EMIT countChanged();
@@ -263,17 +270,7 @@ uint MultitaskviewSurfaceModel::prevSameAppIndex(uint index)
         qCWarning(lcTlPlugin) << "prevSameAppIndex: invalid index" << index << "count:" << count();
         return index;
     }
-    auto circularPrev = [this](uint i) {
-        return (i + count() - 1) % count();
-    };
-    auto i = circularPrev(index);
-    for (; i != index; i = circularPrev(i)) {
-        if (m_data[i]->wrapper->appId()
-            == m_data[index]->wrapper->appId()) {
-            break;
-        }
-    }
-    return i;
+    return m_data[index]->prevSameAppIndex;
 }
 
 uint MultitaskviewSurfaceModel::nextSameAppIndex(uint index)
@@ -282,17 +279,7 @@ uint MultitaskviewSurfaceModel::nextSameAppIndex(uint index)
         qCWarning(lcTlPlugin) << "nextSameAppIndex: invalid index" << index << "count:" << count();
         return index;
     }
-    auto circularNext = [this](uint i) {
-        return (i + 1) % count();
-    };
-    auto i = circularNext(index);
-    for (; i != index; i = circularNext(i)) {
-        if (m_data[i]->wrapper->appId()
-            == m_data[index]->wrapper->appId()) {
-            break;
-        }
-    }
-    return i;
+    return m_data[index]->nextSameAppIndex;
 }
 
 QRectF MultitaskviewSurfaceModel::layoutArea() const
@@ -309,28 +296,57 @@ void MultitaskviewSurfaceModel::setLayoutArea(const QRectF &newLayoutArea)
     Q_EMIT layoutAreaChanged();
 }
 
+MultitaskviewSurfaceModel::LayoutMetrics MultitaskviewSurfaceModel::layoutMetrics() const
+{
+    auto config = Helper::instance()->config();
+    auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
+    LayoutMetrics metrics;
+    metrics.topContentMargin = config->multitaskviewTopContentMargin() / devicePixelRatio;
+    metrics.bottomContentMargin = config->multitaskviewBottomContentMargin() / devicePixelRatio;
+    metrics.cellPadding = config->multitaskviewCellPadding() / devicePixelRatio;
+    metrics.horizontalMargin = config->multitaskviewHorizontalMargin() / devicePixelRatio;
+    metrics.availWidth = std::max(0.0, layoutArea().width() - 2 * metrics.horizontalMargin);
+    metrics.availHeight = std::max(
+        0.0,
+        layoutArea().height() - metrics.topContentMargin - metrics.bottomContentMargin);
+    metrics.loadFactor = config->multitaskviewLoadFactor();
+    return metrics;
+}
+
 bool MultitaskviewSurfaceModel::tryLayout(const QList<ModelDataPtr> &rawData,
+                                          const LayoutMetrics &metrics,
                                           qreal rowH,
-                                          bool ignoreOverlap)
+                                          bool ignoreOverlap,
+                                          qsizetype firstDirty)
 {
-    int nrows = 1;
-    qreal acc = 0;
-    auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
-    auto topContentMargin =
-        Helper::instance()->config()->multitaskviewTopContentMargin() / devicePixelRatio;
-    auto bottomContentMargin =
-        Helper::instance()->config()->multitaskviewBottomContentMargin() / devicePixelRatio;
-    auto cellPadding = Helper::instance()->config()->multitaskviewCellPadding() / devicePixelRatio;
-    auto horizontalMargin =
-        Helper::instance()->config()->multitaskviewHorizontalMargin() / devicePixelRatio;
-    auto availWidth = std::max(0.0, layoutArea().width() - 2 * horizontalMargin);
-    auto availHeight =
-        std::max(0.0, layoutArea().height() - topContentMargin - bottomContentMargin);
+    const auto cellPadding = metrics.cellPadding;
+    const auto availWidth = metrics.availWidth;
     if (availWidth <= 0)
         return false;
     QList<QList<ModelDataPtr>> rowstmp;
+    qsizetype firstIndex = 0;
+    // Rows are filled greedily, so with the same row height and metrics every row in
+    // front of the first changed window (and the window following it) comes out the
+    // same as last time. Keep those and only re-lay the rest.
+    if (firstDirty > 0 && rowH == m_rowHeight && metrics == m_rowsMetrics) {
+        for (const auto &row : std::as_const(m_rows)) {
+            if (firstIndex + row.size() >= firstDirty)
+                break;
+            if (!std::ranges::equal(row, rawData.sliced(firstIndex, row.size())))
+                break;
+            rowstmp.append(row);
+            firstIndex += row.size();
+        }
+        // Earlier failed tries may have touched the pending values of reused windows.
+        for (qsizetype i = 0; i < firstIndex; ++i) {
+            rawData[i]->pendingGeometry.setWidth(rawData[i]->geometry.width());
+            rawData[i]->pendingPadding = rawData[i]->padding;
+        }
+    }
+    int nrows = static_cast<int>(rowstmp.size()) + 1;
+    qreal acc = 0;
     QList<ModelDataPtr> currow;
-    for (auto &modelData : rawData) {
+    for (auto &modelData : rawData.sliced(firstIndex)) {
         auto surface = modelData->wrapper;
         auto whRatio = surface->width() / surface->height();
         modelData->pendingPadding = surface->height() < (rowH - 2 * cellPadding);
@@ -342,7 +358,7 @@ bool MultitaskviewSurfaceModel::tryLayout(const QList<ModelDataPtr> &rawData,
         if (newAcc <= availWidth) {
             acc = newAcc;
             currow.append(modelData);
-        } else if (newAcc / availWidth > Helper::instance()->config()->multitaskviewLoadFactor()) {
+        } else if (newAcc / availWidth > metrics.loadFactor) {
             acc = curW;
             nrows++;
             rowstmp.append(currow);
@@ -355,57 +371,55 @@ bool MultitaskviewSurfaceModel::tryLayout(const QList<ModelDataPtr> &rawData,
             acc = newAcc;
         }
     }
-    if (nrows * rowH <= availHeight || ignoreOverlap) {
+    if (nrows * rowH <= metrics.availHeight || ignoreOverlap) {
         if (currow.length()) {
             rowstmp.append(currow);
         }
         m_rowHeight = rowH;
         m_rows = rowstmp;
+        m_rowsMetrics = metrics;
         return true;
     }
     return false;
 }
 
-void MultitaskviewSurfaceModel::calcDisplayPos(const QList<ModelDataPtr> &rawData)
+void MultitaskviewSurfaceModel::calcDisplayPos(const QList<ModelDataPtr> &rawData,
+                                               const LayoutMetrics &metrics)
 {
-    auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
-    auto topContentMargin =
-        Helper::instance()->config()->multitaskviewTopContentMargin() / devicePixelRatio;
-    auto bottomContentMargin =
-        Helper::instance()->config()->multitaskviewBottomContentMargin() / devicePixelRatio;
-    auto cellPadding = Helper::instance()->config()->multitaskviewCellPadding() / devicePixelRatio;
-    auto horizontalMargin =
-        Helper::instance()->config()->multitaskviewHorizontalMargin() / devicePixelRatio;
-    auto availWidth = std::max(0.0, layoutArea().width() - 2 * horizontalMargin);
-    auto availHeight =
-        std::max(0.0, layoutArea().height() - topContentMargin - bottomContentMargin);
+    const auto cellPadding = metrics.cellPadding;
+    QHash<const SurfaceModelData *, int> rowIndex;
+    rowIndex.reserve(rawData.size());
+    for (int i = 0; i < rawData.size(); ++i)
+        rowIndex.insert(rawData[i].get(), i);
+    auto indexOf = [&rowIndex](const ModelDataPtr &data) {
+        return rowIndex.value(data.get(), -1);
+    };
     auto contentHeight = m_rows.length() * m_rowHeight;
-    auto curY = std::max(availHeight - contentHeight, 0.0) / 2 + topContentMargin;
-    const auto hCenter = availWidth / 2;
+    auto curY = std::max(metrics.availHeight - contentHeight, 0.0) / 2 + metrics.topContentMargin;
+    const auto hCenter = metrics.availWidth / 2;
     for (auto i = 0; i < m_rows.size(); ++i) {
-        auto row = m_rows[i];
-        const auto totW = QtConcurrent::blockingMappedReduced(
-            row,
-            [cellPadding](ModelDataPtr data) {
-                return data->pendingGeometry.width() + 2 * cellPadding;
-            },
-            [](qreal &acc, const qreal &cur) {
-                acc += cur;
-            });
-        auto curX = hCenter - totW / 2 + cellPadding + horizontalMargin;
+        const auto &row = m_rows[i];
+        const auto totW = std::accumulate(row.cbegin(),
+                                          row.cend(),
+                                          0.0,
+                                          [cellPadding](qreal acc, const ModelDataPtr &data) {
+                                              return acc + data->pendingGeometry.width()
+                                                  + 2 * cellPadding;
+                                          });
+        auto curX = hCenter - totW / 2 + cellPadding + metrics.horizontalMargin;
         for (auto j = 0; j < row.size(); ++j) {
             auto window = row[j];
             window->pendingGeometry.moveLeft(curX);
             window->pendingGeometry.moveTop(curY);
             window->pendingGeometry.setHeight(m_rowHeight - 2 * cellPadding);
-            window->pendingLeftIndex = rawData.indexOf(row[(j - 1 + row.size()) % row.size()]);
-            window->pendingRightIndex = rawData.indexOf(row[(j + 1) % row.size()]);
-            auto lastRow = m_rows[std::max(0, i - 1)];
+            window->pendingLeftIndex = indexOf(row[(j - 1 + row.size()) % row.size()]);
+            window->pendingRightIndex = indexOf(row[(j + 1) % row.size()]);
+            const auto &lastRow = m_rows[std::max(0, i - 1)];
             auto lastRowIndex = std::min(static_cast<int>(lastRow.size()) - 1, j);
-            window->pendingUpIndex = rawData.indexOf(lastRow[lastRowIndex]);
-            auto nextRow = m_rows[std::min(static_cast<int>(m_rows.size()) - 1, i + 1)];
+            window->pendingUpIndex = indexOf(lastRow[lastRowIndex]);
+            const auto &nextRow = m_rows[std::min(static_cast<int>(m_rows.size()) - 1, i + 1)];
             auto nextRowIndex = std::min(static_cast<int>(nextRow.size()) - 1, j);
-            window->pendingDownIndex = rawData.indexOf(nextRow[nextRowIndex]);
+            window->pendingDownIndex = indexOf(nextRow[nextRowIndex]);
             curX += window->pendingGeometry.width() + 2 * cellPadding;
         }
         curY += m_rowHeight;
@@ -413,8 +427,10 @@ void MultitaskviewSurfaceModel::calcDisplayPos(const QList<ModelDataPtr> &rawDat
     m_contentHeight = curY;
 }
 
-void MultitaskviewSurfaceModel::doCalculateLayout(const QList<ModelDataPtr> &rawData)
+void MultitaskviewSurfaceModel::doCalculateLayout(const QList<ModelDataPtr> &rawData,
+                                                  qsizetype firstDirty)
 {
+    const auto metrics = layoutMetrics();
     auto devicePixelRatio = output()->outputItem()->devicePixelRatio();
     auto maxWindowHeight =
         std::min(layoutArea().height(),
@@ -422,16 +438,63 @@ void MultitaskviewSurfaceModel::doCalculateLayout(const QList<ModelDataPtr> &raw
     auto minWindowHeight = Helper::instance()->config()->minMultitaskviewSurfaceHeight() / devicePixelRatio;
     auto windowHeightStep = Helper::instance()->config()->windowHeightStep() / devicePixelRatio;
     auto rowH = maxWindowHeight;
-    while (rowH > minWindowHeight) {
-        if (tryLayout(rawData, rowH)) {
+
+    // A single added or removed window moves the row height by a few steps at most,
+    // so search from the current height instead of from the maximum.
+    if (firstDirty >= 0 && m_rowHeight > 0 && windowHeightStep > 0 && metrics == m_rowsMetrics) {
+        const auto laidOut = std::accumulate(m_rows.cbegin(),
+                                             m_rows.cend(),
+                                             qsizetype(0),
+                                             [](qsizetype acc, const QList<ModelDataPtr> &row) {
+                                                 return acc + row.size();
+                                             });
+        if (rawData.size() < laidOut) {
+            qreal fitted = 0;
+            for (auto h = m_rowHeight + windowHeightStep; h <= maxWindowHeight;
+                 h += windowHeightStep) {
+                if (!tryLayout(rawData, metrics, h))
+                    break;
+                fitted = h;
+            }
+            if (fitted > 0) {
+                // Redo the last fitting height, a failed try may have followed it.
+                tryLayout(rawData, metrics, fitted);
+                calcDisplayPos(rawData, metrics);
+                return;
+            }
+        }
+        if (tryLayout(rawData, metrics, m_rowHeight, false, firstDirty)) {
+            calcDisplayPos(rawData, metrics);
+            return;
+        }
+        rowH = m_rowHeight - windowHeightStep;
+    }
+
+    bool laidOut = false;
+    for (; rowH > minWindowHeight; rowH -= windowHeightStep) {
+        if (tryLayout(rawData, metrics, rowH)) {
+            laidOut = true;
             break;
         }
-        rowH -= windowHeightStep;
     }
-    if (rowH < minWindowHeight) {
-        tryLayout(rawData, minWindowHeight, true);
+    if (!laidOut) {
+        tryLayout(rawData, metrics, minWindowHeight, true);
+    }
+    calcDisplayPos(rawData, metrics);
+}
+
+void MultitaskviewSurfaceModel::updateSameAppIndex()
+{
+    QHash<QString, QList<int>> appIndex;
+    for (int i = 0; i < m_data.size(); ++i)
+        appIndex[m_data[i]->wrapper->appId()].append(i);
+    for (const auto &indices : std::as_const(appIndex)) {
+        for (int k = 0; k < indices.size(); ++k) {
+            auto &data = m_data[indices[k]];
+            data->prevSameAppIndex = indices[(k - 1 + indices.size()) % indices.size()];
+            data->nextSameAppIndex = indices[(k + 1) % indices.size()];
+        }
     }
-    calcDisplayPos(rawData);
 }
 
 void MultitaskviewSurfaceModel::doUpdateZOrder(const QList<ModelDataPtr> &rawData)
@@ -563,6 +626,11 @@ void MultitaskviewSurfaceModel::handleSurfaceAdded(SurfaceWrapper *surface)
             this,
             &MultitaskviewSurfaceModel::handleSurfaceStateChanged,
             Qt::UniqueConnection);
+    connect(surface,
+            &SurfaceWrapper::appIdChanged,
+            this,
+            &MultitaskviewSurfaceModel::updateSameAppIndex,
+            Qt::UniqueConnection);
     if (surface->ownsOutput() == output()) {
         if (surfaceReady(surface)) {
             addReadySurface(surface);
@@ -620,7 +688,7 @@ void MultitaskviewSurfaceModel::addReadySurface(SurfaceWrapper *surface)
     auto insertedIt = pendingData.insert(it, toBeInserted);
     int insertedIndex = std::distance(pendingData.begin(), insertedIt);
     Q_ASSERT(insertedIndex >= 0 && insertedIndex < pendingData.size());
-    doCalculateLayout(pendingData);
+    doCalculateLayout(pendingData, insertedIndex);
     auto [beginIndex, endIndex] = commitAndGetUpdateRange(m_data);
     if (beginIndex <= endIndex) {
         Q_ASSERT(beginIndex < m_data.size());
@@ -637,6 +705,7 @@ void MultitaskviewSurfaceModel::addReadySurface(SurfaceWrapper *surface)
     beginInsertRows({}, insertedIndex, insertedIndex);
     m_data = pendingData;
     pendingData.clear();
+    updateSameAppIndex();
     endInsertRows();
     Q_EMIT rowsChanged();
     Q_EMIT countChanged();
@@ -654,8 +723,9 @@ bool MultitaskviewSurfaceModel::removeReadySurface(SurfaceWrapper *surface)
     int toRemove = std::distance(m_data.begin(), toBeRemovedIt);
     beginRemoveRows({}, toRemove, toRemove);
     m_data.remove(toRemove);
+    updateSameAppIndex();
     endRemoveRows();
-    doCalculateLayout(m_data);
+    doCalculateLayout(m_data, toRemove);
     auto [beginIndex, endIndex] = commitAndGetUpdateRange(m_data);
     if (beginIndex <= endIndex) {
         Q_ASSERT(beginIndex < m_data.size());
@@ -704,6 +774,10 @@ void MultitaskviewSurfaceModel::disconnectSurface(SurfaceWrapper *surface)
                &SurfaceWrapper::surfaceStateChanged,
                this,
                &MultitaskviewSurfaceModel::handleSurfaceStateChanged);
+    disconnect(surface,
+               &SurfaceWrapper::appIdChanged,
+               this,
+               &MultitaskviewSurfaceModel::updateSameAppIndex);
     disconnect(surface,
                &SurfaceWrapper::normalGeometryChanged,
                this,
@@ -105,6 +105,11 @@ class MultitaskviewSurfaceModel : public QAbstractListModel
         int pendingLeftIndex;
         int pendingRightIndex;
 
+        // Circular links to the previous/next window of the same app, refreshed by
+        // updateSameAppIndex() whenever the model's row order or a window's appId changes.
+        int prevSameAppIndex{ 0 };
+        int nextSameAppIndex{ 0 };
+
         void commit()
         {
             geometry = pendingGeometry;
@@ -118,6 +123,20 @@ class MultitaskviewSurfaceModel : public QAbstractListModel
 
     using ModelDataPtr = std::shared_ptr<SurfaceModelData>;
 
+    // Config derived values used by one layout pass, read once instead of per try.
+    struct LayoutMetrics
+    {
+        qreal topContentMargin{ 0 };
+        qreal bottomContentMargin{ 0 };
+        qreal cellPadding{ 0 };
+        qreal horizontalMargin{ 0 };
+        qreal availWidth{ 0 };
+        qreal availHeight{ 0 };
+        qreal loadFactor{ 0 };
+
+        bool operator==(const LayoutMetrics &other) const = default;
+    };
+
 public:
     MultitaskviewSurfaceModel(QObject *parent = nullptr);
     void initializeModel();
@@ -176,9 +195,15 @@ Q_SIGNALS:
     void countChanged();
 
 private:
-    bool tryLayout(const QList<ModelDataPtr> &rawData, qreal rowH, bool ignoreOverlap = false);
-    void calcDisplayPos(const QList<ModelDataPtr> &rawData);
-    void doCalculateLayout(const QList<ModelDataPtr> &rawData);
+    LayoutMetrics layoutMetrics() const;
+    bool tryLayout(const QList<ModelDataPtr> &rawData,
+                   const LayoutMetrics &metrics,
+                   qreal rowH,
+                   bool ignoreOverlap = false,
+                   qsizetype firstDirty = 0);
+    void calcDisplayPos(const QList<ModelDataPtr> &rawData, const LayoutMetrics &metrics);
+    void doCalculateLayout(const QList<ModelDataPtr> &rawData, qsizetype firstDirty = -1);
+    void updateSameAppIndex();
     void doUpdateZOrder(const QList<ModelDataPtr> &rawData);
     std::pair<int, int> commitAndGetUpdateRange(const QList<ModelDataPtr> &rawData);
     void handleWrapperGeometryChanged();
@@ -201,6 +226,7 @@ private:
     QRectF m_layoutArea{};
     QList<QList<ModelDataPtr>> m_rows{};
     qreal m_rowHeight{ 0 };
+    LayoutMetrics m_rowsMetrics{};
     qreal m_contentHeight{ 0 };
     bool m_modelReady;
     QList<ModelDataPtr> m_toBeInserted;
@@ -59,6 +59,7 @@
 #include "treelanduserconfig.hpp"
 #include "utils/cmdline.h"
 #include "utils/fpsdisplaymanager.h"
+#include "utils/tracerecorder.h"
 #include "wallpaper/wallpapermanager.h"
 #include "wallpapershellinterfacev1.h"
 #include "workspace/workspace.h"
@@ -114,6 +115,7 @@
 #include <QQmlContext>
 #include <QQuickWindow>
 #include <QThreadPool>
+#include <QTouchEvent>
 
 #include <algorithm>
 #include <functional>
@@ -121,6 +123,7 @@
 #include <pwd.h>
 #include <unistd.h>
 #include <utility>
+#include <vector>
 
 #define EXT_DATA_CONTROL_MANAGER_V1_VERSION 1
 #define WLR_FRACTIONAL_SCALE_V1_VERSION 1
@@ -239,6 +242,117 @@ static wlr_output_mode *closestOutputMode(WOutput *output,
     return closestMode;
 }
 
+static void setOutputState(wlr_output_state *state, const WOutputState &outputState)
+{
+    wlr_output_state_set_enabled(state, outputState.enabled);
+    // wlroots doesn't allow setting these properties on disabled outputs.
+    if (!outputState.enabled)
+        return;
+
+    if (outputState.mode) {
+        wlr_output_state_set_mode(state, outputState.mode);
+    } else {
+        wlr_output_state_set_custom_mode(state,
+                                         outputState.customModeSize.width(),
+                                         outputState.customModeSize.height(),
+                                         outputState.customModeRefresh);
+    }
+    wlr_output_state_set_scale(state, outputState.scale);
+    wlr_output_state_set_transform(state, static_cast<wl_output_transform>(outputState.transform));
+    wlr_output_state_set_adaptive_sync_enabled(state, outputState.adaptiveSyncEnabled);
+}
+
+// The states of several outputs, tested or committed in one backend commit. The DRM
+// backend checks the outputs against the CRTCs and the link bandwidth together and
+// modesets them at once, one output at a time may pass each test and still fail as a whole.
+class BackendOutputStates
+{
+public:
+    explicit BackendOutputStates(qsizetype count)
+    {
+        // The states hold a pixman region, don't move them once they are initialized.
+        m_states.reserve(count);
+    }
+
+    ~BackendOutputStates()
+    {
+        for (auto &state : m_states)
+            wlr_output_state_finish(&state.base);
+    }
+
+    Q_DISABLE_COPY_MOVE(BackendOutputStates)
+
+    wlr_output_state *add(WOutput *output)
+    {
+        Q_ASSERT(m_states.size() < m_states.capacity());
+        auto &state = m_states.emplace_back();
+        state.output = output->handle();
+        wlr_output_state_init(&state.base);
+        return &state.base;
+    }
+
+    bool isEmpty() const { return m_states.empty(); }
+
+    bool test(wlr_backend *backend) { return commit(backend, true); }
+
+    bool commit(wlr_backend *backend, bool testOnly = false)
+    {
+        if (m_states.empty())
+            return true;
+
+        // A modeset can't be tested or committed without a buffer of the new size.
+        wlr_output_swapchain_manager manager;
+        wlr_output_swapchain_manager_init(&manager, backend);
+        auto finish = qScopeGuard([&manager] {
+            wlr_output_swapchain_manager_finish(&manager);
+        });
+        if (!wlr_output_swapchain_manager_prepare(&manager, m_states.data(), m_states.size()))
+            return false;
+        if (testOnly)
+            return true;
+
+        // Like wlr_output_commit_state(), outputs that light up or change their mode show
+        // a cleared buffer until the scene renders into them.
+        for (auto &state : m_states) {
+            if (!needsNewBuffer(state))
+                continue;
+            auto *swapchain = wlr_output_swapchain_manager_get_swapchain(&manager, state.output);
+            auto *buffer = swapchain ? wlr_swapchain_acquire(swapchain) : nullptr;
+            if (!buffer)
+                return false;
+            auto *pass = wlr_renderer_begin_buffer_pass(state.output->renderer, buffer, nullptr);
+            wlr_render_rect_options options = {};
+            options.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+            if (pass)
+                wlr_render_pass_add_rect(pass, &options);
+            if (!pass || !wlr_render_pass_submit(pass)) {
+                wlr_buffer_unlock(buffer);
+                return false;
+            }
+            wlr_output_state_set_buffer(&state.base, buffer);
+            wlr_buffer_unlock(buffer);
+        }
+
+        if (!wlr_backend_commit(backend, m_states.data(), m_states.size()))
+            return false;
+        wlr_output_swapchain_manager_apply(&manager);
+        return true;
+    }
+
+private:
+    static bool needsNewBuffer(const wlr_backend_output_state &state)
+    {
+        const auto committed = state.base.committed;
+        if (!state.output->renderer || (committed & WLR_OUTPUT_STATE_BUFFER))
+            return false;
+        if ((committed & WLR_OUTPUT_STATE_ENABLED) && !state.base.enabled)
+            return false;
+        return (committed & WLR_OUTPUT_STATE_ENABLED) || (committed & WLR_OUTPUT_STATE_MODE);
+    }
+
+    std::vector<wlr_backend_output_state> m_states;
+};
+
 static bool outputMatchesId(Output *output, const QString &outputId)
 {
     return output && output->output() && output->output()->isEnabled()
@@ -274,6 +388,26 @@ Helper::Helper(QObject *parent)
                                                       QString()));
 
     m_renderWindow->setColor(Qt::black);
+
+    // Record input, client commits and output frames for tests/test_trace_replay
+    if (const QString traceFile = qEnvironmentVariable("TREELAND_TRACE_FILE"); !traceFile.isEmpty()) {
+        m_traceRecorder = new TraceRecorder(this);
+        if (m_traceRecorder->open(traceFile)) {
+            connect(m_renderWindow,
+                    &WOutputRenderWindow::renderEnd,
+                    m_traceRecorder,
+                    [this](const QList<QPointer<WOutput>> &committedOutputs) {
+                        for (const auto &output : committedOutputs) {
+                            if (output)
+                                m_traceRecorder->recordOutputFrame(output);
+                        }
+                    });
+        } else {
+            delete m_traceRecorder;
+            m_traceRecorder = nullptr;
+        }
+    }
+
     m_rootSurfaceContainer->setFlag(QQuickItem::ItemIsFocusScope, true);
     m_rootSurfaceContainer->setFocusPolicy(Qt::StrongFocus);
 
@@ -285,6 +419,17 @@ Helper::Helper(QObject *parent)
     tryInitRemoteSource();
 
     m_outputManagerHelper = new OutputManager(m_rootSurfaceContainer, m_globalConfig.get(), this);
+    m_outputIdleManager = new OutputIdleManager(m_globalConfig.get(), this);
+    connect(m_outputIdleManager,
+            &OutputIdleManager::stateChanged,
+            this,
+            &Helper::onOutputIdleStateChanged);
+    connect(m_globalConfig.get(), &TreelandConfig::dimIdleOutputsChanged, this, [this] {
+        for (auto *output : std::as_const(m_outputList)) {
+            if (m_outputIdleManager->state(output) == OutputIdleManager::State::Idle)
+                output->setIdleDimmed(m_globalConfig->dimIdleOutputs());
+        }
+    });
     connect(m_outputManagerHelper,
             &OutputManager::copyOutputConfigurationChanged,
             this,
@@ -503,6 +648,7 @@ void Helper::onOutputAdded(WOutput *output)
         o = createCopyOutput(output, m_rootSurfaceContainer->primaryOutput());
     }
     m_outputList.append(o);
+    m_outputIdleManager->addOutput(o);
     const bool outputRegistered = ensureOutputInRootContainer(o);
     if (!outputRegistered) {
         qCWarning(lcTlCore) << "Failed to register output in root container" << output->name();
@@ -719,6 +865,14 @@ void Helper::onOutputRemoved(WOutput *output)
 {
     // Drop the per-output request_state listener registered via output->listeners(this).
     output->removeListeners(this);
+    // WOutputHelper drops the commit jobs of a removed output, count its commit as
+    // failed so the configuration and its layout change still finish.
+    if (m_pendingOutputConfig.committingOutputs.contains(output))
+        onOutputCommitFinished(m_pendingOutputConfig.config, output, false);
+    m_pendingOutputConfig.states.removeIf([output](const WOutputState &state) {
+        return state.output == output;
+    });
+
     auto index = indexOfOutput(output);
     Q_ASSERT(index >= 0);
     const auto o = m_outputList.takeAt(index);
@@ -851,6 +1005,7 @@ void Helper::onOutputRemoved(WOutput *output)
     m_wallpaperManager->removeOutputWallpaper(output->handle());
 
     m_powerOffOutputs.remove(output->handle());
+    m_outputIdleManager->removeOutput(o);
 
     delete o;
 }
@@ -1008,36 +1163,19 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
         }
     }
 
-    if (onlyTest) {
-        bool ok = true;
-        for (const auto &state : std::as_const(states)) {
-            WOutputViewport *viewport = getOwnOutputViewport(state.output);
-            if (!viewport) {
-                ok = false;
-                continue;
-            }
-
-            WOutputRenderWindow *renderWindow = viewport->outputRenderWindow();
-            if (!renderWindow) {
-                ok = false;
-                continue;
-            }
-            WOutputStateGuard newState;
-            wlr_output_state_set_enabled(newState.get(), state.enabled);
-            if (state.enabled) {
-                if (state.mode)
-                    wlr_output_state_set_mode(newState.get(), state.mode);
-                else
-                    wlr_output_state_set_custom_mode(newState.get(), state.customModeSize.width(),
-                                             state.customModeSize.height(),
-                                             state.customModeRefresh);
-                wlr_output_state_set_adaptive_sync_enabled(newState.get(), state.adaptiveSyncEnabled);
-                wlr_output_state_set_transform(newState.get(), static_cast<wl_output_transform>(state.transform));
-                wlr_output_state_set_scale(newState.get(), state.scale);
-            }
-            ok &= wlr_output_test_state(state.output->handle(), newState.get());
-        }
+    BackendOutputStates backendStates(states.size());
+    for (const auto &state : std::as_const(states))
+        setOutputState(backendStates.add(state.output), state);
+    // Also before applying, a configuration the outputs can't take together is rejected
+    // before any of them blanks for a modeset.
+    const bool testOk = backendStates.test(m_backend->handle());
 
+    if (onlyTest) {
+        const bool ok = testOk
+            && std::all_of(states.cbegin(), states.cend(), [this](const WOutputState &state) {
+                   WOutputViewport *viewport = getOwnOutputViewport(state.output);
+                   return viewport && viewport->outputRenderWindow();
+               });
         m_outputManager->sendResult(config, ok);
         return;
     }
@@ -1045,6 +1183,14 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
     if (m_pendingOutputConfig.config) {
         m_outputManager->sendResult(m_pendingOutputConfig.config, false);
     }
+    finishPendingOutputLayoutChange();
+
+    if (!testOk) {
+        qCWarning(lcTlCore) << "Rejecting output configuration, the outputs failed the test commit";
+        m_outputManager->sendResult(config, false);
+        m_pendingOutputConfig = {};
+        return;
+    }
 
     // Handle Copy Mode transition when primary output is disabled
     if (m_mode == OutputMode::Copy) {
@@ -1061,7 +1207,7 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
 
     m_pendingOutputConfig.config = config;
     m_pendingOutputConfig.states = states;
-    m_pendingOutputConfig.pendingCommits = 0;
+    m_pendingOutputConfig.committingOutputs.clear();
     m_pendingOutputConfig.allSuccess = true;
 
     if (scanned && m_outputManagerHelper && m_globalConfig && !m_globalConfig->singleOutputId().isEmpty()) {
@@ -1123,6 +1269,16 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
         }
     }
 
+    // Moving and committing the outputs changes the layout once per output, the scene is
+    // arranged once when the last commit finished.
+    m_rootSurfaceContainer->beginOutputLayoutChange();
+    m_pendingOutputConfig.layoutChangeBegun = true;
+    auto failApply = [this, config] {
+        m_outputManager->sendResult(config, false);
+        finishPendingOutputLayoutChange();
+        m_pendingOutputConfig = {};
+    };
+
     for (const auto &state : std::as_const(states)) {
         // Skip outputs that have been removed (e.g., disabled in Copy mode)
         Output *output = getOutput(state.output);
@@ -1132,16 +1288,14 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
 
         WOutputViewport *viewport = getOwnOutputViewport(state.output);
         if (!viewport) {
-            m_outputManager->sendResult(config, false);
-            m_pendingOutputConfig = {};
+            failApply();
             return;
         }
 
         WOutputRenderWindow *renderWindow = viewport->outputRenderWindow();
         if (!renderWindow) {
             qCWarning(lcTlCore) << "No renderWindow for output" << state.output->name();
-            m_outputManager->sendResult(config, false);
-            m_pendingOutputConfig = {};
+            failApply();
             return;
         }
 
@@ -1150,8 +1304,7 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
             if (!layout || !m_rootSurfaceContainer->outputs().contains(output)) {
                 qCWarning(lcTlCore) << "Cannot apply enabled output configuration; output is not in root container"
                                     << state.output->name();
-                m_outputManager->sendResult(config, false);
-                m_pendingOutputConfig = {};
+                failApply();
                 return;
             }
             if (layout->outputs().contains(state.output)) {
@@ -1162,32 +1315,14 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
         auto outputHelper = renderWindow->getOutputHelper(viewport);
         if (!outputHelper) {
             qCWarning(lcTlCore) << "No output helper for viewport" << viewport;
-            m_outputManager->sendResult(config, false);
-            m_pendingOutputConfig = {};
+            failApply();
             return;
         }
 
+        // The mode, scale and transform are persisted only after a successful enabled commit.
         WOutputHelper::ExtraState extraState;
-        wlr_output_state_set_enabled(extraState.get(), state.enabled);
-
-        // Only set mode/scale/transform properties when enabling output.
-        // wlroots doesn't allow setting these properties on disabled outputs,
-        // so they are persisted only after a successful enabled commit.
+        setOutputState(extraState.get(), state);
         if (state.enabled) {
-            if (state.mode) {
-                wlr_output_state_set_mode(extraState.get(), state.mode);
-            } else {
-                wlr_output_state_set_custom_mode(extraState.get(),
-                                                 state.customModeSize.width(),
-                                                 state.customModeSize.height(),
-                                                 state.customModeRefresh);
-            }
-
-            wlr_output_state_set_scale(extraState.get(), state.scale);
-            wlr_output_state_set_transform(extraState.get(),
-                                          static_cast<wl_output_transform>(state.transform));
-            wlr_output_state_set_adaptive_sync_enabled(extraState.get(), state.adaptiveSyncEnabled);
-
             if (auto outputItem = qobject_cast<WOutputItem*>(viewport->parentItem())) {
                 QMetaObject::invokeMethod(outputItem, "setTransform",
                     Q_ARG(QVariant, QVariant::fromValue(static_cast<WOutput::Transform>(state.transform))));
@@ -1196,8 +1331,7 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
 
         if (!outputHelper->setExtraState(extraState)) {
             qCWarning(lcTlCore) << "Failed to set extra state for output" << state.output->name();
-            m_outputManager->sendResult(config, false);
-            m_pendingOutputConfig = {};
+            failApply();
             return;
         }
         auto config = m_pendingOutputConfig.config;
@@ -1211,6 +1345,7 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
              renderWindow,
              viewport,
              output = QPointer<WOutput>(state.output),
+             committingOutput = state.output,
              outputPosition,
              enabled](bool success, WOutputHelper::ExtraState committedState) {
                 if (!self) {
@@ -1226,7 +1361,7 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
                             layout->remove(output);
                         }
                     }
-                    self->onOutputCommitFinished(config, success);
+                    self->onOutputCommitFinished(config, committingOutput, success);
                     if (success && committedState) {
                         bool wasStateOnlyCommit = (committedState->committed & (WLR_OUTPUT_STATE_MODE |
                                                                                 WLR_OUTPUT_STATE_SCALE |
@@ -1242,12 +1377,12 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
                     qCWarning(lcTlCore) << "Commit callback received unexpected state pointer!"
                                             << "Expected:" << extraState.get()
                                             << "Got:" << committedState.get();
-                    self->onOutputCommitFinished(config, false);
+                    self->onOutputCommitFinished(config, committingOutput, false);
                 }
             },
             WOutputHelper::AfterCommitStage
         );
-        m_pendingOutputConfig.pendingCommits++;
+        m_pendingOutputConfig.committingOutputs.insert(state.output);
         renderWindow->update(viewport);
 
         // Special handling for disabled → enabled transition
@@ -1257,15 +1392,25 @@ void Helper::onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyT
             renderWindow->render(viewport, true);
         }
     }
+
+    if (m_pendingOutputConfig.committingOutputs.isEmpty())
+        finishPendingOutputLayoutChange();
 }
 
-void Helper::onOutputCommitFinished(wlr_output_configuration_v1 *config, bool success)
+void Helper::finishPendingOutputLayoutChange()
+{
+    if (std::exchange(m_pendingOutputConfig.layoutChangeBegun, false))
+        m_rootSurfaceContainer->endOutputLayoutChange();
+}
+
+void Helper::onOutputCommitFinished(wlr_output_configuration_v1 *config, WOutput *output, bool success)
 {
     if (!config) {
         return;
     }
 
-    if (config != m_pendingOutputConfig.config) {
+    if (config != m_pendingOutputConfig.config
+        || !m_pendingOutputConfig.committingOutputs.remove(output)) {
         return;
     }
 
@@ -1273,8 +1418,8 @@ void Helper::onOutputCommitFinished(wlr_output_configuration_v1 *config, bool su
         m_pendingOutputConfig.allSuccess = false;
     }
 
-    m_pendingOutputConfig.pendingCommits--;
-    if (m_pendingOutputConfig.pendingCommits == 0) {
+    if (m_pendingOutputConfig.committingOutputs.isEmpty()) {
+        finishPendingOutputLayoutChange();
         bool ok = m_pendingOutputConfig.allSuccess;
         if (ok) {
             m_outputManagerHelper->storeSingleOutputConfig();
@@ -1348,33 +1493,109 @@ void Helper::onOutputCommitFinished(wlr_output_configuration_v1 *config, bool su
     }
 }
 
+void Helper::updateOutputsTearing()
+{
+    // Only a fullscreen client that is the sole thing on screen may tear, anything
+    // composited on top of it (effects, popups, the fps overlay...) goes back to vsync.
+    SurfaceWrapper *tearingSurface = nullptr;
+    if (m_tearingControlManager && m_currentMode == CurrentMode::Normal && !m_fpsDisplay) {
+        auto *wrapper = activatedSurface();
+        if (wrapper && wrapper->surface()
+            && wrapper->surfaceState() == SurfaceWrapper::State::Fullscreen
+            && !wrapper->isAnimationRunning() && !wrapper->blur()
+            && !m_rootSurfaceContainer->getSeatContainerOrDefault(m_primarySeat)->hasPopupGrab()
+            && wlr_tearing_control_manager_v1_surface_hint_from_surface(
+                   m_tearingControlManager, wrapper->surface()->handle())
+                == WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC) {
+            tearingSurface = wrapper;
+        }
+    }
+
+    // Panels, notifications and OSDs in the top and overlay layers are composited over
+    // the fullscreen client, an output showing any of them stays on vsync.
+    QList<QRectF> layerRects;
+    if (tearingSurface) {
+        for (auto *wrapper : std::as_const(m_rootSurfaceContainer->surfaces())) {
+            if (wrapper->type() != SurfaceWrapper::Type::Layer || !wrapper->isVisible()
+                || !wrapper->surface() || !wrapper->surface()->mapped())
+                continue;
+            auto *layer = qobject_cast<WLayerSurface *>(wrapper->shellSurface());
+            if (layer
+                && (layer->layer() == WLayerSurface::LayerType::Top
+                    || layer->layer() == WLayerSurface::LayerType::Overlay)) {
+                layerRects.append(wrapper->mapRectToScene(QRectF(QPointF(0, 0), wrapper->size())));
+            }
+        }
+    }
+
+    for (Output *output : std::as_const(m_outputList)) {
+        if (!output->screenViewport())
+            continue;
+        const QRectF outputRect = output->geometry();
+        const bool covered = std::any_of(layerRects.cbegin(), layerRects.cend(), [&](const QRectF &rect) {
+            return rect.intersects(outputRect);
+        });
+        output->screenViewport()->setAllowTearing(tearingSurface
+                                                  && tearingSurface->ownsOutput() == output
+                                                  && !covered);
+    }
+}
+
 void Helper::onSetOutputPowerMode(wlr_output_power_v1_set_mode_event *event)
 {
-    auto output = event->output;
+    setOutputPower(event->output, event->mode == ZWLR_OUTPUT_POWER_V1_MODE_ON);
+}
+
+// Only the outputs powered off here are powered on again, not the ones disabled
+// by output management.
+bool Helper::setOutputPower(wlr_output *output, bool on)
+{
     WOutputStateGuard newState;
 
-    switch (event->mode) {
-    case ZWLR_OUTPUT_POWER_V1_MODE_OFF:
+    if (!on) {
         if (m_powerOffOutputs.contains(output))
-            return; // already disabled by output_power
+            return true; // already disabled by output_power
         if (!output->enabled)
-            return; // already disabled by output_management, not ours
+            return false; // already disabled by output_management, not ours
         wlr_output_state_set_enabled(newState.get(), false);
         if (!wlr_output_commit_state(output, newState.get())) {
             qCCritical(lcTlCore, "commit failed on output %s", output->name);
-            return;
+            return false;
         }
         m_powerOffOutputs.insert(output);
-        break;
-    case ZWLR_OUTPUT_POWER_V1_MODE_ON:
+    } else {
         if (!m_powerOffOutputs.remove(output))
-            return; // not disabled by output_power, nothing to do
+            return false; // not disabled by output_power, nothing to do
         wlr_output_state_set_enabled(newState.get(), true);
         if (!wlr_output_commit_state(output, newState.get())) {
             qCCritical(lcTlCore, "commit failed on output %s", output->name);
             m_powerOffOutputs.insert(output);
-            return;
+            return false;
         }
+    }
+
+    return true;
+}
+
+void Helper::onOutputIdleStateChanged(Output *output, OutputIdleManager::State state)
+{
+    auto *wlr_output = output->output()->handle();
+
+    switch (state) {
+    case OutputIdleManager::State::Active:
+        if (m_powerOffOutputs.contains(wlr_output))
+            setOutputPower(wlr_output, true);
+        output->setIdleDimmed(false);
+        Q_EMIT outputIdleChanged(output->output(), false);
+        break;
+    case OutputIdleManager::State::Idle:
+        output->setIdleDimmed(m_globalConfig->dimIdleOutputs());
+        Q_EMIT outputIdleChanged(output->output(), true);
+        break;
+    case OutputIdleManager::State::Off:
+        // Nothing is committed to a disabled output, its frames stop with it.
+        Q_EMIT outputIdleChanged(output->output(), true);
+        setOutputPower(wlr_output, false);
         break;
     }
 }
@@ -1432,8 +1653,12 @@ void Helper::updateIdleInhibitor()
 {
     if (m_screensaverInterfaceV1->isInhibited()) {
         wlr_idle_notifier_v1_set_inhibited(m_idleNotifier, true);
+        m_outputIdleManager->setInhibitedOutputs({}, true);
         return;
     }
+
+    bool inhibited = false;
+    QSet<Output *> inhibitedOutputs;
     for (auto *inhibitor : std::as_const(m_idleInhibitors)) {
         auto wsurface = WSurface::fromHandle(inhibitor->surface);
         if (!wsurface)
@@ -1444,11 +1669,16 @@ void Helper::updateIdleInhibitor()
             visible &= !toplevel->isMinimized();
 
         if (visible) {
-            wlr_idle_notifier_v1_set_inhibited(m_idleNotifier, true);
-            return;
+            inhibited = true;
+            // Keep only the output showing the inhibitor awake, e.g. the one playing
+            // a video, the other outputs may still go idle.
+            auto wrapper = m_rootSurfaceContainer->getSurface(wsurface);
+            if (wrapper && wrapper->ownsOutput())
+                inhibitedOutputs.insert(wrapper->ownsOutput());
         }
     }
-    wlr_idle_notifier_v1_set_inhibited(m_idleNotifier, false);
+    wlr_idle_notifier_v1_set_inhibited(m_idleNotifier, inhibited);
+    m_outputIdleManager->setInhibitedOutputs(inhibitedOutputs, false);
 }
 
 void Helper::onShowDesktop()
@@ -1603,6 +1833,22 @@ void Helper::onRestoreCopyOutput(VirtualOutputInterfaceV1 *interface)
 
 void Helper::onSurfaceWrapperAdded(SurfaceWrapper *wrapper)
 {
+    if (Q_UNLIKELY(m_traceRecorder) && wrapper->surface()) {
+        auto *surface = wrapper->surface();
+        connect(surface, &WSurface::commit, m_traceRecorder, [this, surface](quint32 committedState) {
+            m_traceRecorder->recordCommit(surface, committedState);
+        });
+        connect(surface, &WSurface::beforeDestroy, m_traceRecorder, [this, surface] {
+            m_traceRecorder->recordSurfaceDestroyed(surface);
+        });
+    }
+
+    // The output showing an idle inhibitor stays awake, follow the window across outputs.
+    connect(wrapper, &SurfaceWrapper::ownsOutputChanged, this, [this] {
+        if (!m_idleInhibitors.isEmpty())
+            updateIdleInhibitor();
+    });
+
     if (wrapper->isIMCandidatePanel())
         return;
 
@@ -2069,6 +2315,28 @@ void Helper::init(Treeland::Treeland *treeland)
 
     if (!wlr_viewporter_create(m_server->handle()))
         qCCritical(lcTlCore) << "Failed to create viewporter";
+    if (!wlr_presentation_create(m_server->handle(), m_backend->handle(), 2))
+        qCCritical(lcTlCore) << "Failed to create presentation time";
+    m_tearingControlManager = wlr_tearing_control_manager_v1_create(m_server->handle(), 1);
+    if (m_tearingControlManager) {
+        // The hints are applied when the next frame is committed, so pick them up right
+        // before rendering instead of tracking every state the decision depends on.
+        connect(m_renderWindow,
+                &WOutputRenderWindow::beforeRendering,
+                this,
+                &Helper::updateOutputsTearing);
+    } else {
+        qCCritical(lcTlCore) << "Failed to create tearing control manager";
+    }
+    // Without it clients keep using implicit sync.
+    if (WRenderHelper::supportsExplicitSync(m_renderer, m_backend->handle())) {
+        if (!wlr_linux_drm_syncobj_manager_v1_create(m_server->handle(),
+                                                     1,
+                                                     wlr_renderer_get_drm_fd(m_renderer)))
+            qCWarning(lcTlCore) << "Failed to create linux drm syncobj manager";
+    } else {
+        qCInfo(lcTlCore) << "Explicit synchronization is not available";
+    }
     m_renderWindow->init(m_renderer, m_allocator);
 
     m_xwaylandOutputManager =
@@ -2420,7 +2688,11 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
     }
 
     if (event->isInputEvent()) {
+        if (Q_UNLIKELY(m_traceRecorder))
+            m_traceRecorder->recordInput(event);
+
         wlr_idle_notifier_v1_notify_activity(m_idleNotifier, seat->handle());
+        m_outputIdleManager->notifyActivity();
 
         // Wake DPMS-off outputs on any input event
         // Only re-enable outputs disabled by output_power, not user-disabled outputs
@@ -2562,6 +2834,7 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
         seat->cursor()->setVisible(true);
     } else if (event->type() == QEvent::TouchBegin) {
         seat->cursor()->setVisible(false);
+        m_touchDragPredictor.reset();
     }
 
     if (m_currentMode != CurrentMode::LockScreen)
@@ -2573,7 +2846,18 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
         if (Q_LIKELY(event->type() == QEvent::MouseMove || event->type() == QEvent::TouchUpdate)) {
             auto cursor = seat->cursor();
             Q_ASSERT(cursor);
-            QMouseEvent *ev = static_cast<QMouseEvent *>(event);
+            QPointF globalPosition;
+            if (event->type() == QEvent::TouchUpdate) {
+                auto *te = static_cast<QTouchEvent *>(event);
+                if (te->points().isEmpty())
+                    return true;
+                m_touchDragPredictor.setLookahead(InputDevice::instance()->motionPredictionLookahead());
+                m_touchDragPredictor.addSample(te->points().constFirst().globalPosition(),
+                                               te->timestamp());
+                globalPosition = m_touchDragPredictor.predicted();
+            } else {
+                globalPosition = static_cast<QMouseEvent *>(event)->globalPosition();
+            }
 
             const auto &moveResizeState = seatContainer->moveResizeState();
             auto ownsOutput = moveResizeState.surface->ownsOutput();
@@ -2582,7 +2866,7 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
                 return false;
             }
 
-            auto increment_pos = ev->globalPosition() - moveResizeState.initialPosition;
+            auto increment_pos = globalPosition - moveResizeState.initialPosition;
             m_rootSurfaceContainer->doMoveResizeForSeat(seat, increment_pos);
             // Edge-tiling detection during move (resize is not tiled).
             if (moveResizeState.edges == Qt::Edges())
@@ -2593,8 +2877,21 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
                    && static_cast<QKeyEvent *>(event)->key() == Qt::Key_Escape) {
             m_rootSurfaceContainer->cancelMoveResizeForSeat(seat);
             return true;
-        } else if (event->type() == QEvent::MouseButtonRelease
-                   || event->type() == QEvent::TouchEnd) {
+        } else if (event->type() == QEvent::MouseButtonRelease) {
+            m_rootSurfaceContainer->endMoveResizeForSeat(seat);
+        } else if (event->type() == QEvent::TouchEnd || event->type() == QEvent::TouchCancel) {
+            // The drag was drawn ahead of the finger, end it where the finger really is.
+            auto *te = static_cast<QTouchEvent *>(event);
+            const bool hasPosition = !te->points().isEmpty() || m_touchDragPredictor.hasSample();
+            if (hasPosition && seatContainer->moveResizeState().surface->ownsOutput()) {
+                const QPointF globalPosition = te->points().isEmpty()
+                    ? m_touchDragPredictor.position()
+                    : te->points().constFirst().globalPosition();
+                m_rootSurfaceContainer->doMoveResizeForSeat(
+                    seat,
+                    globalPosition - seatContainer->moveResizeState().initialPosition);
+            }
+            m_touchDragPredictor.reset();
             m_rootSurfaceContainer->endMoveResizeForSeat(seat);
         }
     }
@@ -2626,6 +2923,51 @@ bool Helper::beforeDisposeEvent(WSeat *seat, QWindow *targetWindow, QInputEvent
     return false;
 }
 
+bool Helper::wantsKeyEvent(WSeat *seat,
+                           int key,
+                           Qt::KeyboardModifiers modifiers,
+                           [[maybe_unused]] bool pressed)
+{
+    if (!m_instance || !m_renderWindow || !m_backend)
+        return true;
+
+    // Everything beforeDisposeEvent does with a key besides notifying the activity.
+    if (Q_UNLIKELY(m_traceRecorder) || seat != m_primarySeat || m_captureSelector
+        || m_currentMode != CurrentMode::Normal || !m_powerOffOutputs.isEmpty()
+        || m_shortcutManager->isCaptureActive()) {
+        return true;
+    }
+
+    switch (key) {
+    case Qt::Key_Meta:
+    case Qt::Key_Super_L:
+    case Qt::Key_Super_R:
+    case Qt::Key_Alt:
+    case Qt::Key_Control:
+    case Qt::Key_Shift:
+    case Qt::Key_Escape:
+        return true;
+    default:
+        break;
+    }
+
+    const auto ctrlAlt = Qt::ControlModifier | Qt::AltModifier;
+    if ((modifiers & Qt::MetaModifier) || ((modifiers & ctrlAlt) == ctrlAlt))
+        return true;
+
+    if (auto *seatContainer = m_rootSurfaceContainer->getSeatContainer(seat);
+        seatContainer && seatContainer->moveResizeState().surface) {
+        return true;
+    }
+
+    if (m_shortcutManager->controller()->hasKeyBinding(QKeyCombination(modifiers, Qt::Key(key))))
+        return true;
+
+    wlr_idle_notifier_v1_notify_activity(m_idleNotifier, seat->handle());
+    m_outputIdleManager->notifyActivity();
+    return false;
+}
+
 bool Helper::afterHandleEvent([[maybe_unused]] WSeat *seat,
                               WSurface *watched,
                               QObject *surfaceItem,
@@ -2691,7 +3033,7 @@ bool Helper::doGesture(QInputEvent *event)
             break;
         case Qt::PanNativeGesture:
             if (e->libInputGestureType() == WGestureEvent::WLibInputGestureType::SwipeGesture)
-                InputDevice::instance()->processSwipeUpdate(e->delta());
+                InputDevice::instance()->processSwipeUpdate(e->delta(), e->timestamp());
         case Qt::ZoomNativeGesture:
         case Qt::SmartZoomNativeGesture:
         case Qt::RotateNativeGesture:
@@ -3179,6 +3521,51 @@ void Helper::addOutput()
     }
 }
 
+QString Helper::createVirtualOutput(const QSize &requestedSize, int refreshMilliHz)
+{
+    const QSize size = requestedSize.boundedTo(QSize(MaxVirtualOutputSize, MaxVirtualOutputSize));
+    refreshMilliHz = std::min(refreshMilliHz, MaxVirtualOutputRefresh);
+    if (size.isEmpty() || refreshMilliHz < 0) {
+        qCWarning(lcTlOutput) << "Invalid virtual output mode" << requestedSize << refreshMilliHz;
+        return {};
+    }
+
+    // onOutputAdded runs inside, the Output exists once this returns.
+    WOutput *output = m_backend->createHeadlessOutput(size);
+    if (!output) {
+        qCWarning(lcTlOutput) << "Failed to create virtual output" << size;
+        return {};
+    }
+
+    WOutputStateGuard state;
+    wlr_output_state_set_enabled(state.get(), true);
+    wlr_output_state_set_custom_mode(state.get(), size.width(), size.height(), refreshMilliHz);
+    if (!wlr_output_commit_state(output->handle(), state.get())) {
+        qCCritical(lcTlOutput) << "commit failed on virtual output" << output->name();
+        wlr_output_destroy(output->handle());
+        return {};
+    }
+
+    qCInfo(lcTlOutput) << "Created virtual output" << output->name() << size << refreshMilliHz;
+    m_virtualOutputNames.insert(output->name());
+    return output->name();
+}
+
+bool Helper::removeVirtualOutput(const QString &name)
+{
+    if (!m_virtualOutputNames.contains(name))
+        return false;
+
+    Output *output = findOutputByName(name);
+    m_virtualOutputNames.remove(name);
+    if (!output)
+        return false;
+
+    qCInfo(lcTlOutput) << "Remove virtual output" << name;
+    wlr_output_destroy(output->output()->handle());
+    return true;
+}
+
 void Helper::setOutputMode(OutputMode mode)
 {
     if (m_outputList.isEmpty())
@@ -3751,6 +4138,9 @@ void Helper::restoreExtensionModeFromConfig(bool preserveSingleOutputConfig)
     m_outputManagerHelper->setMode(OutputManager::Mode::Extension);
     Q_EMIT outputModeChanged();
 
+    // Arrange the scene once for all outputs that are enabled, moved and restored here.
+    m_rootSurfaceContainer->beginOutputLayoutChange();
+
     for (auto *outputObject : std::as_const(m_outputList)) {
         if (!outputObject || !outputObject->output()) {
             continue;
@@ -3820,6 +4210,7 @@ void Helper::restoreExtensionModeFromConfig(bool preserveSingleOutputConfig)
                                        outputObject,
                                        std::move(restoreOutput));
     }
+    m_rootSurfaceContainer->endOutputLayoutChange();
 
     // A temporary fallback must not replace an unavailable single-output target.
     // Other extension-mode transitions persist the currently enabled topology.
@@ -4014,25 +4405,36 @@ void Helper::handleRequestDragForSeat(WSeat *seat, WSurface *)
 
 void Helper::enableAllOutput()
 {
+    QList<WOutput *> outputs;
     for (auto *output : std::as_const(m_outputList)) {
-        if (!output || !output->output()) {
-            continue;
-        }
+        if (output && output->output())
+            outputs.append(output->output());
+    }
 
-        WOutputStateGuard state;
-        wlr_output_state_set_enabled(state.get(), true);
-        const bool ok = wlr_output_commit_state(output->output()->handle(), state.get());
+    // Light up all outputs in one modeset, fall back to one output at a time if the
+    // backend can't take them together.
+    BackendOutputStates states(outputs.size());
+    for (auto *output : std::as_const(outputs))
+        wlr_output_state_set_enabled(states.add(output), true);
+    const bool committedAll = states.commit(m_backend->handle());
 
-        if (!ok) {
-            qCWarning(lcTlOutput) << "Failed to enable output" << output->output()->name();
-            continue;
+    m_rootSurfaceContainer->beginOutputLayoutChange();
+    for (auto *output : std::as_const(outputs)) {
+        if (!committedAll) {
+            WOutputStateGuard state;
+            wlr_output_state_set_enabled(state.get(), true);
+            if (!wlr_output_commit_state(output->handle(), state.get())) {
+                qCWarning(lcTlOutput) << "Failed to enable output" << output->name();
+                continue;
+            }
         }
 
         if (auto *layout = m_rootSurfaceContainer->outputLayout();
-            layout && !layout->outputs().contains(output->output())) {
-            layout->autoAdd(output->output());
+            layout && !layout->outputs().contains(output)) {
+            layout->autoAdd(output);
         }
     }
+    m_rootSurfaceContainer->endOutputLayoutChange();
 }
 
 WSeat *Helper::getLastInteractingSeat(SurfaceWrapper *surface) const
@@ -5,12 +5,14 @@
 
 #include <wlr_fwd.h>
 #include "core/qmlengine.h"
+#include "input/motionpredictor.h"
 #include "modules/activation/activationmanagerinterfacev1.h"
 #include "modules/shortcut/shortcutmanager.h"
 #include "modules/virtual-output/virtualoutputmanagerinterfacev1.h"
 #include "modules/wallpaper/wallpapermanagerinterfacev1.h"
 #include "modules/wallpaper/wallpapernotifierinterfacev1.h"
 #include "modules/window-management/windowmanagementinterfacev1.h"
+#include "output/outputidlemanager.h"
 #include "utils/fpsdisplaymanager.h"
 
 #include <xcb/xproto.h>
@@ -119,6 +121,7 @@ class ShortcutManagerV2;
 class ShortcutRunner;
 class SurfaceContainer;
 class SurfaceWrapper;
+class TraceRecorder;
 class TreelandConfig;
 class TreelandUserConfig;
 class TreelandRemoteSource;
@@ -200,6 +203,15 @@ public:
     OutputMode outputMode() const;
     void setOutputMode(OutputMode mode);
     Q_INVOKABLE void addOutput();
+    // Headless outputs for remote desktop, only rendered when their content changes or a
+    // capture client asks for a frame. An empty name if the output can't be created.
+    // The size is clamped to MaxVirtualOutputSize and the refresh rate to
+    // MaxVirtualOutputRefresh, in mHz, 0 picks the default rate.
+    QString createVirtualOutput(const QSize &size, int refreshMilliHz);
+    // Only removes outputs created by createVirtualOutput().
+    bool removeVirtualOutput(const QString &name);
+    static constexpr int MaxVirtualOutputSize = 8192;
+    static constexpr int MaxVirtualOutputRefresh = 240000;
 
     void addSocket(WSocket *socket);
     [[nodiscard]] WXWayland *createXWayland();
@@ -303,6 +315,7 @@ Q_SIGNALS:
     void showDesktopRequested(WOutput *output);
     void showDesktopStateChanged();
     void startLockscreened(WOutput *output, bool showAnimation);
+    void outputIdleChanged(WOutput *output, bool idle);
     void modifierKeyReleased(QKeyEvent *event);
 
 private Q_SLOTS:
@@ -319,7 +332,10 @@ private:
     void setGamma(struct wlr_gamma_control_manager_v1_set_gamma_event *event);
     void onOutputTestOrApply(wlr_output_configuration_v1 *config, bool onlyTest);
     void onSetOutputPowerMode(wlr_output_power_v1_set_mode_event *event);
+    bool setOutputPower(wlr_output *output, bool on);
+    void onOutputIdleStateChanged(Output *output, OutputIdleManager::State state);
     void onNewIdleInhibitor(wlr_idle_inhibitor_v1 *inhibitor);
+    void updateOutputsTearing();
     void onSetCopyOutput(VirtualOutputInterfaceV1 *interface);
     void onRestoreCopyOutput(VirtualOutputInterfaceV1 *interface);
     void onSurfaceWrapperAdded(SurfaceWrapper *wrapper);
@@ -350,6 +366,7 @@ private:
     bool afterHandleEvent(WSeat *seat, WSurface *watched, QObject *shellObject,
                          QObject *eventObject, QInputEvent *event) override;
     bool unacceptedEvent(WSeat *seat, QWindow *window, QInputEvent *event) override;
+    bool wantsKeyEvent(WSeat *seat, int key, Qt::KeyboardModifiers modifiers, bool pressed) override;
     void onRenderWindowActiveFocusItemChanged();
     void handleLeftButtonStateChanged(const QInputEvent *event);
     void handleWhellValueChanged(const QInputEvent *event);
@@ -395,6 +412,7 @@ private:
     std::unique_ptr<TreelandConfig> m_globalConfig;
     Treeland::Treeland *m_treeland = nullptr;
     FpsDisplayManager *m_fpsManager = nullptr;
+    TraceRecorder *m_traceRecorder = nullptr;
     SessionManager *m_sessionManager = nullptr;
     WallpaperManager *m_wallpaperManager = nullptr;
 
@@ -428,6 +446,7 @@ private:
     wlr_idle_notifier_v1 *m_idleNotifier = nullptr;
     WPointer<wlr_idle_inhibit_manager_v1> m_idleInhibitManager;
     WPointer<wlr_output_power_manager_v1> m_outputPowerManager;
+    WPointer<wlr_tearing_control_manager_v1> m_tearingControlManager;
     wlr_ext_foreign_toplevel_image_capture_source_manager_v1 *m_foreignToplevelImageCaptureManager = nullptr;
 
     // Per-output request_state listeners are managed via output->listeners(this):
@@ -482,7 +501,12 @@ private:
     // private data
     QList<Output *> m_outputList;
     QSet<wlr_output *> m_powerOffOutputs;
+    // Names of the outputs created by createVirtualOutput(), wlroots never reuses them.
+    QSet<QString> m_virtualOutputNames;
+    // Moves windows dragged by touch to where the finger will be.
+    MotionPredictor m_touchDragPredictor;
     OutputManager *m_outputManagerHelper = nullptr;
+    OutputIdleManager *m_outputIdleManager = nullptr;
     QPointer<QQuickItem> m_taskSwitch;
     QList<wlr_idle_inhibitor_v1 *> m_idleInhibitors;
 
@@ -513,12 +537,15 @@ private:
     struct PendingOutputConfig {
         wlr_output_configuration_v1 *config = nullptr;
         QList<WOutputState> states;
-        int pendingCommits = 0;
+        // The outputs whose commit job hasn't run yet.
+        QSet<WOutput *> committingOutputs;
         bool allSuccess = true;
+        bool layoutChangeBegun = false;
     };
     PendingOutputConfig m_pendingOutputConfig;
 
-    void onOutputCommitFinished(wlr_output_configuration_v1 *config, bool success);
+    void finishPendingOutputLayoutChange();
+    void onOutputCommitFinished(wlr_output_configuration_v1 *config, WOutput *output, bool success);
 
     SeatsManager *m_seatManager = nullptr;
     InputManager *m_inputManager = nullptr;
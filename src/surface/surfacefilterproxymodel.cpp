@@ -10,6 +10,51 @@ SurfaceFilterProxyModel::SurfaceFilterProxyModel(QObject *parent)
 {
 }
 
+void SurfaceFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (sourceModel == this->sourceModel())
+        return;
+
+    if (m_workspaceModel) {
+        disconnect(m_workspaceModel,
+                   &WorkspaceModel::surfaceAdded,
+                   this,
+                   &SurfaceFilterProxyModel::watchSurface);
+        disconnect(m_workspaceModel,
+                   &WorkspaceModel::surfaceRemoved,
+                   this,
+                   &SurfaceFilterProxyModel::unwatchSurface);
+        disconnect(m_workspaceModel,
+                   &WorkspaceModel::activeHistoryChanged,
+                   this,
+                   &SurfaceFilterProxyModel::markSortDirty);
+        for (auto surface : std::as_const(m_workspaceModel->surfaces()))
+            unwatchSurface(surface);
+    }
+
+    m_workspaceModel = qobject_cast<WorkspaceModel *>(sourceModel);
+    if (m_workspaceModel) {
+        for (auto surface : std::as_const(m_workspaceModel->surfaces()))
+            watchSurface(surface);
+        connect(m_workspaceModel,
+                &WorkspaceModel::surfaceAdded,
+                this,
+                &SurfaceFilterProxyModel::watchSurface);
+        connect(m_workspaceModel,
+                &WorkspaceModel::surfaceRemoved,
+                this,
+                &SurfaceFilterProxyModel::unwatchSurface);
+        connect(m_workspaceModel,
+                &WorkspaceModel::activeHistoryChanged,
+                this,
+                &SurfaceFilterProxyModel::markSortDirty);
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    m_filterDirty = false;
+    m_sortDirty = true;
+}
+
 void SurfaceFilterProxyModel::setFilterAppId(const QString &appid)
 {
     if (m_filterAppId == appid)
@@ -37,6 +82,30 @@ QVariantList SurfaceFilterProxyModel::surfaceSnapshot() const
     return surfaces;
 }
 
+void SurfaceFilterProxyModel::ensureUpToDate()
+{
+    if (sortColumn() < 0) {
+        m_sortDirty = false;
+        sort(0);
+    } else if (m_sortDirty) {
+        // sort() returns early on an already sorted proxy, so force a re-sort when only
+        // the activation order behind lessThan() changed. This re-runs the filter too.
+        m_sortDirty = false;
+        m_filterDirty = false;
+        invalidate();
+    }
+
+    if (m_filterDirty) {
+        m_filterDirty = false;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
+        beginFilterChange();
+        endFilterChange();
+#else
+        invalidateFilter();
+#endif
+    }
+}
+
 int SurfaceFilterProxyModel::activeIndex()
 {
     return m_activeIndex;
@@ -71,16 +140,49 @@ bool SurfaceFilterProxyModel::filterAcceptsRow(int source_row,
 bool SurfaceFilterProxyModel::lessThan(const QModelIndex &source_left,
                                        const QModelIndex &source_right) const
 {
-    WorkspaceModel *model = dynamic_cast<WorkspaceModel *>(sourceModel());
     SurfaceWrapper *left = sourceModel()->data(source_left).value<SurfaceWrapper *>();
     SurfaceWrapper *right = sourceModel()->data(source_right).value<SurfaceWrapper *>();
 
-    if (model && left && right) {
-        if (model->laterActiveThan(left, right))
-            return true;
-        else
-            return false;
+    if (m_workspaceModel && left && right) {
+        return m_workspaceModel->laterActiveThan(left, right);
     }
 
     return QSortFilterProxyModel::lessThan(source_left, source_right);
 }
+
+void SurfaceFilterProxyModel::watchSurface(SurfaceWrapper *surface)
+{
+    connect(surface,
+            &SurfaceWrapper::skipSwitcherChanged,
+            this,
+            &SurfaceFilterProxyModel::markFilterDirty,
+            Qt::UniqueConnection);
+    // filterAcceptsRow() compares the appId when filtering by application.
+    connect(surface,
+            &SurfaceWrapper::appIdChanged,
+            this,
+            &SurfaceFilterProxyModel::markFilterDirty,
+            Qt::UniqueConnection);
+}
+
+void SurfaceFilterProxyModel::unwatchSurface(SurfaceWrapper *surface)
+{
+    disconnect(surface,
+               &SurfaceWrapper::skipSwitcherChanged,
+               this,
+               &SurfaceFilterProxyModel::markFilterDirty);
+    disconnect(surface,
+               &SurfaceWrapper::appIdChanged,
+               this,
+               &SurfaceFilterProxyModel::markFilterDirty);
+}
+
+void SurfaceFilterProxyModel::markFilterDirty()
+{
+    m_filterDirty = true;
+}
+
+void SurfaceFilterProxyModel::markSortDirty()
+{
+    m_sortDirty = true;
+}
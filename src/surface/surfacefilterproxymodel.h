@@ -3,8 +3,12 @@
 
 #pragma once
 
+#include <QPointer>
 #include <QSortFilterProxyModel>
 
+class SurfaceWrapper;
+class WorkspaceModel;
+
 class SurfaceFilterProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
@@ -13,9 +17,15 @@ class SurfaceFilterProxyModel : public QSortFilterProxyModel
 public:
     explicit SurfaceFilterProxyModel(QObject *parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
     Q_INVOKABLE void setFilterAppId(const QString &appid);
     Q_INVOKABLE QVariantList surfaceSnapshot() const;
 
+    // Re-filters or re-sorts only if skipSwitcher or the activation order changed
+    // since the last call; rows added or removed meanwhile are already in place.
+    void ensureUpToDate();
+
     int activeIndex();
     void setActiveIndex(int index);
 
@@ -27,6 +37,14 @@ protected:
     bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const override;
 
 private:
+    void watchSurface(SurfaceWrapper *surface);
+    void unwatchSurface(SurfaceWrapper *surface);
+    void markFilterDirty();
+    void markSortDirty();
+
     QString m_filterAppId;
     mutable int m_activeIndex = -1;
+    QPointer<WorkspaceModel> m_workspaceModel;
+    bool m_filterDirty = true;
+    bool m_sortDirty = true;
 };
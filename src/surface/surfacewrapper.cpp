@@ -115,12 +115,16 @@ SurfaceWrapper::SurfaceWrapper(SurfaceWrapper *original, QQuickItem *parent)
         QColor bgColor = original->prelaunchSplash()
             ? original->prelaunchSplash()->property("backgroundColor").value<QColor>()
             : QColor("#ffffff");
+        const QUrl snapshot = original->prelaunchSplash()
+            ? original->prelaunchSplash()->property("snapshot").toUrl()
+            : QUrl();
 
         m_prelaunchSplash =
             m_engine->createPrelaunchSplash(this,
                                             original->radius(),
                                             iconVar.value<wlr_buffer *>(),
-                                            bgColor);
+                                            bgColor,
+                                            snapshot);
         setNoDecoration(false);
 
         connect(original, &SurfaceWrapper::surfaceItemCreated, this, [this, original]() {
@@ -141,7 +145,8 @@ SurfaceWrapper::SurfaceWrapper(QmlEngine *qmlEngine,
                                const QSize &initialSize,
                                const QString &appId,
                                wlr_buffer *iconBuffer,
-                               const QColor &backgroundColor)
+                               const QColor &backgroundColor,
+                               const QUrl &snapshot)
     : QQuickItem(parent)
     , m_engine(qmlEngine)
     , m_shellSurface(nullptr)
@@ -182,7 +187,7 @@ SurfaceWrapper::SurfaceWrapper(QmlEngine *qmlEngine,
         setImplicitSize(800, 600);
     }
     m_prelaunchSplash =
-        m_engine->createPrelaunchSplash(this, radius(), iconBuffer, backgroundColor);
+        m_engine->createPrelaunchSplash(this, radius(), iconBuffer, backgroundColor, snapshot);
 
     setNoDecoration(false);
     updateHasActiveCapability(ActiveControlState::HasActivateCapability, true);
@@ -750,8 +755,18 @@ void SurfaceWrapper::completeSplashTransition(const QSizeF &targetImplicitSize,
             Qt::QueuedConnection);
     }
     Q_ASSERT(m_prelaunchSplash);
-    m_prelaunchSplash->setVisible(false);
-    m_prelaunchSplash->deleteLater();
+    if (m_prelaunchSplash->property("hasSnapshot").toBool()) {
+        // Crossfade from the last frame of the previous run to the real surface.
+        auto splash = m_prelaunchSplash.data();
+        splash->setZ(m_surfaceItem->z() + 1);
+        bool ok = connect(splash, SIGNAL(fadeOutFinished()), splash, SLOT(deleteLater()));
+        Q_ASSERT(ok);
+        ok = QMetaObject::invokeMethod(splash, "fadeOut");
+        Q_ASSERT(ok);
+    } else {
+        m_prelaunchSplash->setVisible(false);
+        m_prelaunchSplash->deleteLater();
+    }
     m_prelaunchSplash = nullptr;
     Q_EMIT prelaunchSplashChanged();
 
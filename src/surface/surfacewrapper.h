@@ -10,6 +10,7 @@
 #include <QPointer>
 #include <QQuickItem>
 #include <QString>
+#include <QUrl>
 #include <QColor>
 
 Q_MOC_INCLUDE(<woutput.h>)
@@ -152,7 +153,8 @@ public:
                             const QSize &initialSize,
                             const QString &appId,
                             wlr_buffer *iconBuffer = nullptr,
-                            const QColor &backgroundColor = QColor("#ffffff"));
+                            const QColor &backgroundColor = QColor("#ffffff"),
+                            const QUrl &snapshot = QUrl());
 
     void setFocus(bool focus, Qt::FocusReason reason);
 
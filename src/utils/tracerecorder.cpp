@@ -0,0 +1,246 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "tracerecorder.h"
+
+#include "common/treelandlogging.h"
+
+#include <woutput.h>
+#include <wsurface.h>
+
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QTouchEvent>
+#include <QWheelEvent>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace TraceFormat {
+
+static Header makeHeader()
+{
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(header.magic));
+    header.version = qToLittleEndian(Version);
+    header.recordSize = qToLittleEndian(quint32(sizeof(Record)));
+    return header;
+}
+
+static Record toLittleEndian(Record record)
+{
+    record.timestamp = qToLittleEndian(record.timestamp);
+    record.type = qToLittleEndian(record.type);
+    record.id = qToLittleEndian(record.id);
+    record.a = qToLittleEndian(record.a);
+    record.b = qToLittleEndian(record.b);
+    record.c = qToLittleEndian(record.c);
+    record.d = qToLittleEndian(record.d);
+    return record;
+}
+
+static Record fromLittleEndian(Record record)
+{
+    record.timestamp = qFromLittleEndian(record.timestamp);
+    record.type = qFromLittleEndian(record.type);
+    record.id = qFromLittleEndian(record.id);
+    record.a = qFromLittleEndian(record.a);
+    record.b = qFromLittleEndian(record.b);
+    record.c = qFromLittleEndian(record.c);
+    record.d = qFromLittleEndian(record.d);
+    return record;
+}
+
+bool load(const QString &fileName, QList<Record> *records, QString *errorString)
+{
+    auto fail = [errorString](const QString &error) {
+        if (errorString)
+            *errorString = error;
+        return false;
+    };
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+
+    Header header;
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)
+        || std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+        return fail(QStringLiteral("not a trace file"));
+    if (qFromLittleEndian(header.version) != Version
+        || qFromLittleEndian(header.recordSize) != sizeof(Record))
+        return fail(QStringLiteral("unsupported trace version %1")
+                        .arg(qFromLittleEndian(header.version)));
+
+    const QByteArray data = file.readAll();
+    const qsizetype count = data.size() / qsizetype(sizeof(Record));
+    records->resize(count);
+    std::memcpy(records->data(), data.constData(), count * sizeof(Record));
+    for (Record &record : *records)
+        record = fromLittleEndian(record);
+
+    return true;
+}
+
+bool save(const QString &fileName, const QList<Record> &records, QString *errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+
+    const Header header = makeHeader();
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const Record &record : records) {
+        const Record le = toLittleEndian(record);
+        file.write(reinterpret_cast<const char *>(&le), sizeof(le));
+    }
+
+    return true;
+}
+
+} // namespace TraceFormat
+
+using TraceFormat::RecordType;
+
+static inline qint32 toFixed(qreal value)
+{
+    return qRound(value * 256);
+}
+
+TraceRecorder::TraceRecorder(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    m_file.close();
+}
+
+bool TraceRecorder::open(const QString &fileName)
+{
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcTlUtils) << "Failed to open trace file" << fileName << m_file.errorString();
+        return false;
+    }
+
+    const TraceFormat::Header header = TraceFormat::makeHeader();
+    m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_clock.start();
+
+    qCInfo(lcTlUtils) << "Recording trace to" << fileName;
+    return true;
+}
+
+void TraceRecorder::recordInput(const QInputEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::MouseMove: {
+        const auto pos = static_cast<const QMouseEvent *>(event)->globalPosition();
+        write(RecordType::PointerMotion, 0, toFixed(pos.x()), toFixed(pos.y()));
+        break;
+    }
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease: {
+        auto mouseEvent = static_cast<const QMouseEvent *>(event);
+        write(RecordType::PointerButton,
+              mouseEvent->button(),
+              event->type() == QEvent::MouseButtonPress);
+        break;
+    }
+    case QEvent::Wheel: {
+        const auto delta = static_cast<const QWheelEvent *>(event)->angleDelta();
+        if (delta.x())
+            write(RecordType::PointerAxis, Qt::Horizontal, delta.x());
+        if (delta.y())
+            write(RecordType::PointerAxis, Qt::Vertical, delta.y());
+        break;
+    }
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease: {
+        auto keyEvent = static_cast<const QKeyEvent *>(event);
+        // WSeat puts the evdev keycode in nativeVirtualKey, nativeScanCode
+        // holds the same key offset to xkb keycodes.
+        write(RecordType::Key,
+              keyEvent->nativeVirtualKey(),
+              event->type() == QEvent::KeyPress,
+              keyEvent->key());
+        break;
+    }
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd:
+    case QEvent::TouchCancel: {
+        for (const auto &point : static_cast<const QTouchEvent *>(event)->points()) {
+            const auto pos = point.globalPosition();
+            switch (point.state()) {
+            case QEventPoint::Pressed:
+                write(RecordType::TouchDown, point.id(), toFixed(pos.x()), toFixed(pos.y()));
+                break;
+            case QEventPoint::Updated:
+                write(RecordType::TouchMotion, point.id(), toFixed(pos.x()), toFixed(pos.y()));
+                break;
+            case QEventPoint::Released:
+                write(RecordType::TouchUp, point.id());
+                break;
+            default:
+                break;
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void TraceRecorder::recordCommit(const WSurface *surface, quint32 committedFields)
+{
+    const QSize size = surface->bufferSize();
+    write(RecordType::SurfaceCommit, idOf(surface), size.width(), size.height(), committedFields);
+}
+
+void TraceRecorder::recordSurfaceDestroyed(const WSurface *surface)
+{
+    write(RecordType::SurfaceDestroy, idOf(surface));
+    m_ids.remove(surface);
+}
+
+void TraceRecorder::recordOutputFrame(const WOutput *output)
+{
+    const QSize size = output->size();
+    write(RecordType::OutputFrame, idOf(output), size.width(), size.height());
+    // Hand the records to the kernel once per frame, a compositor that crashes or
+    // gets killed still leaves the trace up to its last frame.
+    if (m_file.isOpen())
+        m_file.flush();
+}
+
+void TraceRecorder::write(RecordType type, quint32 id, qint32 a, qint32 b, qint32 c)
+{
+    if (!m_file.isOpen())
+        return;
+
+    TraceFormat::Record record{};
+    record.timestamp = m_clock.nsecsElapsed();
+    record.type = quint16(type);
+    record.id = id;
+    record.a = a;
+    record.b = b;
+    record.c = c;
+    record = TraceFormat::toLittleEndian(record);
+    // QFile buffers the writes until recordOutputFrame() flushes them.
+    m_file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+}
+
+quint32 TraceRecorder::idOf(const void *object)
+{
+    auto it = m_ids.constFind(object);
+    if (it == m_ids.constEnd())
+        it = m_ids.insert(object, m_nextId++);
+    return *it;
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <wglobal.h>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QObject>
+
+class QInputEvent;
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+class WOutput;
+class WSurface;
+WAYLIB_SERVER_END_NAMESPACE
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+// A trace file is a Header followed by fixed size Records, all little endian.
+// Objects (surfaces, outputs) are identified by a number unique to the trace,
+// positions are in 1/256 logical pixels. Keys are stored as evdev keycodes,
+// the Qt::Key depends on the keymap active while recording and can't be fed
+// back into a keyboard device.
+namespace TraceFormat {
+
+inline constexpr char Magic[8] = { 'T', 'L', 'T', 'R', 'A', 'C', 'E', '\0' };
+inline constexpr quint32 Version = 2;
+
+enum class RecordType : quint16 {
+    PointerMotion = 1, // a: x, b: y
+    PointerButton,     // id: Qt::MouseButton, a: pressed
+    PointerAxis,       // id: Qt::Orientation, a: angle delta
+    Key,               // id: evdev keycode, a: pressed, b: Qt::Key (informational)
+    TouchDown,         // id: touch point, a: x, b: y
+    TouchMotion,       // id: touch point, a: x, b: y
+    TouchUp,           // id: touch point
+    SurfaceCommit,     // id: surface, a: buffer width, b: buffer height, c: committed fields
+    SurfaceDestroy,    // id: surface
+    OutputFrame,       // id: output, a: width, b: height
+};
+
+struct Header
+{
+    char magic[8];
+    quint32 version;
+    quint32 recordSize;
+};
+
+struct Record
+{
+    quint64 timestamp; // nanoseconds since the recording started
+    quint16 type;
+    quint16 reserved;
+    quint32 id;
+    qint32 a;
+    qint32 b;
+    qint32 c;
+    qint32 d;
+};
+
+static_assert(sizeof(Header) == 16);
+static_assert(sizeof(Record) == 32);
+
+bool load(const QString &fileName, QList<Record> *records, QString *errorString = nullptr);
+bool save(const QString &fileName, const QList<Record> &records, QString *errorString = nullptr);
+
+} // namespace TraceFormat
+
+// Records what drives the compositor (input, client commits, output frames) so a
+// jank report can be replayed deterministically, see tests/test_trace_replay.
+class TraceRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TraceRecorder(QObject *parent = nullptr);
+    ~TraceRecorder() override;
+
+    bool open(const QString &fileName);
+
+    void recordInput(const QInputEvent *event);
+    void recordCommit(const WSurface *surface, quint32 committedFields);
+    void recordSurfaceDestroyed(const WSurface *surface);
+    void recordOutputFrame(const WOutput *output);
+
+private:
+    void write(TraceFormat::RecordType type, quint32 id, qint32 a = 0, qint32 b = 0, qint32 c = 0);
+    quint32 idOf(const void *object);
+
+    QFile m_file;
+    QElapsedTimer m_clock;
+    QHash<const void *, quint32> m_ids;
+    quint32 m_nextId = 1;
+};
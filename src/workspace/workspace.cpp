@@ -273,8 +273,7 @@ SurfaceFilterProxyModel *Workspace::currentFilter()
 {
     WorkspaceModel *wmodel = current();
     m_currentFilter->setSourceModel(wmodel);
-    m_currentFilter->invalidate();
-    m_currentFilter->sort(0);
+    m_currentFilter->ensureUpToDate();
 
     auto *activeSurface = wmodel->latestActiveSurface();
     m_currentFilter->setActiveIndex(wmodel->activeHistoryIndex(activeSurface));
@@ -13,6 +13,11 @@ WorkspaceModel::WorkspaceModel(QObject *parent,
     , m_id(id)
     , m_activedSurfaceHistory(activedSurfaceHistory)
 {
+    const auto count = std::distance(m_activedSurfaceHistory.begin(), m_activedSurfaceHistory.end());
+    m_lastActiveSerial = static_cast<quint64>(count);
+    quint64 serial = m_lastActiveSerial;
+    for (auto surface : std::as_const(m_activedSurfaceHistory))
+        m_activeSerials.insert(surface, serial--);
 }
 
 QString WorkspaceModel::name() const
@@ -85,7 +90,7 @@ void WorkspaceModel::removeSurface(SurfaceWrapper *surface)
     SurfaceListModel::removeSurface(surface);
     surface->setWorkspaceId(-1);
     surface->setHideByWorkspace(false);
-    m_activedSurfaceHistory.remove(surface);
+    removeActivedSurface(surface);
 }
 
 SurfaceWrapper *WorkspaceModel::latestActiveSurface() const
@@ -121,16 +126,23 @@ void WorkspaceModel::pushActivedSurface(SurfaceWrapper *surface)
 {
     m_activedSurfaceHistory.remove(surface);
     m_activedSurfaceHistory.push_front(surface);
+    m_activeSerials.insert(surface, ++m_lastActiveSerial);
+    Q_EMIT activeHistoryChanged();
 }
 
 void WorkspaceModel::removeActivedSurface(SurfaceWrapper *surface)
 {
+    if (!m_activeSerials.remove(surface))
+        return;
     m_activedSurfaceHistory.remove(surface);
+    Q_EMIT activeHistoryChanged();
 }
 
 void WorkspaceModel::clearActivedSurface()
 {
     m_activedSurfaceHistory.clear();
+    m_activeSerials.clear();
+    Q_EMIT activeHistoryChanged();
 }
 
 int WorkspaceModel::activeHistoryIndex(SurfaceWrapper *surface) const
@@ -139,7 +151,8 @@ int WorkspaceModel::activeHistoryIndex(SurfaceWrapper *surface) const
     return static_cast<int>(std::distance(m_activedSurfaceHistory.begin(), it));
 }
 
-bool WorkspaceModel::laterActiveThan(SurfaceWrapper *a, SurfaceWrapper *b)
+bool WorkspaceModel::laterActiveThan(SurfaceWrapper *a, SurfaceWrapper *b) const
 {
-    return activeHistoryIndex(a) < activeHistoryIndex(b);
+    // Surfaces that were never activated get serial 0 and sort after all others.
+    return m_activeSerials.value(a) > m_activeSerials.value(b);
 }
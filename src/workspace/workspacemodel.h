@@ -50,13 +50,14 @@ public:
     void clearActivedSurface();
 
     int activeHistoryIndex(SurfaceWrapper *surface) const;
-    bool laterActiveThan(SurfaceWrapper *a, SurfaceWrapper *b);
+    bool laterActiveThan(SurfaceWrapper *a, SurfaceWrapper *b) const;
 
 Q_SIGNALS:
     void nameChanged();
     void indexChanged();
     void visibleChanged();
     void opaqueChanged();
+    void activeHistoryChanged();
 
 private:
     QString m_name;
@@ -64,4 +65,8 @@ private:
     bool m_visible = false;
     bool m_opaque = true;
     std::forward_list<SurfaceWrapper *> m_activedSurfaceHistory;
+    // Activation serial per surface in m_activedSurfaceHistory, larger is more recent.
+    // Lets laterActiveThan() compare in O(1) instead of walking the history list.
+    QHash<SurfaceWrapper *, quint64> m_activeSerials;
+    quint64 m_lastActiveSerial = 0;
 };
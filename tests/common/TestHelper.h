@@ -27,6 +27,10 @@ WAYLIB_SERVER_USE_NAMESPACE
 
 /// Sets up a minimal wayland server with a headless wlroots backend so the
 /// test gets a real OpenGL context via Mesa llvmpipe — no display required.
+///
+/// Shared by the headless scene tests: each test lists this header in the
+/// SOURCES of its own QML module, so TestHelper is registered as a singleton
+/// under that module's URI.
 class TestHelper : public QObject
 {
     Q_OBJECT
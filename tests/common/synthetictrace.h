@@ -0,0 +1,61 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "utils/tracerecorder.h"
+
+#include <QList>
+
+#include <algorithm>
+
+namespace SyntheticTrace {
+
+inline TraceFormat::Record makeRecord(qint64 msecs,
+                                      TraceFormat::RecordType type,
+                                      quint32 id,
+                                      qint32 a = 0,
+                                      qint32 b = 0,
+                                      qint32 c = 0)
+{
+    TraceFormat::Record record{};
+    record.timestamp = msecs * 1000000;
+    record.type = quint16(type);
+    record.id = id;
+    record.a = a;
+    record.b = b;
+    record.c = c;
+    return record;
+}
+
+/// Two seconds of a 60Hz client resizing while the pointer sweeps the
+/// output and a key is typed every half second, plus a short lived surface.
+/// Used when no recorded trace is given, so the replays always have input
+/// and commits to drive.
+inline QList<TraceFormat::Record> generate()
+{
+    using TraceFormat::RecordType;
+
+    // KEY_A from linux/input-event-codes.h, traces store evdev keycodes.
+    constexpr quint32 keyA = 30;
+
+    QList<TraceFormat::Record> records;
+    for (int frame = 0; frame < 120; ++frame) {
+        const qint64 time = frame * 16;
+        records << makeRecord(time, RecordType::PointerMotion, 0, frame * 8 * 256, frame * 4 * 256);
+        records << makeRecord(time + 2, RecordType::SurfaceCommit, 1, 400 + frame, 300 + frame / 2);
+        if (frame >= 30 && frame < 90)
+            records << makeRecord(time + 4, RecordType::SurfaceCommit, 2, 200, 150);
+        if (frame % 30 == 10) {
+            records << makeRecord(time + 6, RecordType::Key, keyA, true, Qt::Key_A);
+            records << makeRecord(time + 10, RecordType::Key, keyA, false, Qt::Key_A);
+        }
+    }
+    records << makeRecord(90 * 16 + 6, RecordType::SurfaceDestroy, 2);
+    std::stable_sort(records.begin(), records.end(), [](const auto &a, const auto &b) {
+        return a.timestamp < b.timestamp;
+    });
+    return records;
+}
+
+} // namespace SyntheticTrace
@@ -89,46 +89,61 @@ int xdg_toplevel_client_ack_latest_configure(
     return wl_display_roundtrip(connection->display) >= 0;
 }
 
-static int map_toplevel(struct client_connection *connection,
-                        struct xdg_toplevel_client *toplevel,
-                        int width,
-                        int height,
-                        uint32_t argb)
+struct wl_buffer *client_create_solid_buffer(struct wl_shm *shm,
+                                             int width,
+                                             int height,
+                                             uint32_t argb)
 {
-    if (width <= 0 || height <= 0)
-        return 0;
+    if (!shm || width <= 0 || height <= 0)
+        return NULL;
     const int stride = width * 4;
     const size_t size = (size_t)stride * height;
     char name[64];
     snprintf(name, sizeof(name), "/treeland_protocol_xdg_%d", (int)getpid());
     const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
     if (fd < 0)
-        return 0;
+        return NULL;
     shm_unlink(name);
     if (ftruncate(fd, (off_t)size) < 0) {
         close(fd);
-        return 0;
+        return NULL;
     }
     void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     if (data == MAP_FAILED) {
         close(fd);
-        return 0;
+        return NULL;
     }
     uint32_t *pixels = data;
     for (size_t i = 0; i < (size_t)width * height; ++i)
         pixels[i] = argb;
-    struct wl_shm_pool *pool = wl_shm_create_pool(toplevel->shm, fd, (int)size);
-    toplevel->buffer = pool ? wl_shm_pool_create_buffer(pool, 0, width, height, stride,
-                                                         WL_SHM_FORMAT_ARGB8888) : NULL;
+    struct wl_shm_pool *pool = wl_shm_create_pool(shm, fd, (int)size);
+    struct wl_buffer *buffer = pool ? wl_shm_pool_create_buffer(pool, 0, width, height, stride,
+                                                                WL_SHM_FORMAT_ARGB8888) : NULL;
     if (pool)
         wl_shm_pool_destroy(pool);
     munmap(data, size);
     close(fd);
-    if (!toplevel->buffer)
+    return buffer;
+}
+
+int xdg_toplevel_client_commit_solid_buffer(
+    struct client_connection *connection,
+    struct xdg_toplevel_client *toplevel,
+    int width,
+    int height,
+    uint32_t argb)
+{
+    struct wl_buffer *buffer = client_create_solid_buffer(toplevel->shm, width, height, argb);
+    if (!buffer)
         return 0;
-    wl_surface_attach(toplevel->surface, toplevel->buffer, 0, 0);
+    wl_surface_attach(toplevel->surface, buffer, 0, 0);
     wl_surface_damage(toplevel->surface, 0, 0, width, height);
     wl_surface_commit(toplevel->surface);
+    // The compositor keeps its own reference to the committed shm buffer, the
+    // previous one is not needed by the client any more.
+    if (toplevel->buffer)
+        wl_buffer_destroy(toplevel->buffer);
+    toplevel->buffer = buffer;
     return wl_display_roundtrip(connection->display) >= 0;
 }
 
@@ -168,7 +183,8 @@ static int xdg_toplevel_client_create_internal(
         goto failed;
     if (!xdg_toplevel_client_ack_latest_configure(connection, toplevel))
         goto failed;
-    return map_toplevel(connection, toplevel, buffer_width, buffer_height, buffer_argb);
+    return xdg_toplevel_client_commit_solid_buffer(
+        connection, toplevel, buffer_width, buffer_height, buffer_argb);
 
 failed:
     xdg_toplevel_client_destroy(toplevel);
@@ -214,7 +230,7 @@ int xdg_toplevel_client_complete_map(
         return 0;
     if (!xdg_toplevel_client_ack_latest_configure(connection, toplevel))
         return 0;
-    return map_toplevel(connection, toplevel, 1, 1, 0xffffffffu);
+    return xdg_toplevel_client_commit_solid_buffer(connection, toplevel, 1, 1, 0xffffffffu);
 }
 
 int xdg_toplevel_client_create_with_surface_setup(
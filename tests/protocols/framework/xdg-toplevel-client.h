@@ -49,6 +49,21 @@ int xdg_toplevel_client_create_with_surface_setup(
     xdg_surface_setup_callback setup,
     void *data);
 
+// Creates a WIDTHxHEIGHT ARGB8888 shm buffer filled with ARGB.
+struct wl_buffer *client_create_solid_buffer(struct wl_shm *shm,
+                                             int width,
+                                             int height,
+                                             uint32_t argb);
+
+// Attaches and commits a new WIDTHxHEIGHT buffer filled with ARGB, replacing
+// the toplevel's current buffer.
+int xdg_toplevel_client_commit_solid_buffer(
+    struct client_connection *connection,
+    struct xdg_toplevel_client *toplevel,
+    int width,
+    int height,
+    uint32_t argb);
+
 int xdg_toplevel_client_ack_latest_configure(
     struct client_connection *connection,
     struct xdg_toplevel_client *toplevel);
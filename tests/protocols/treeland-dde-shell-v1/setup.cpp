@@ -1,5 +1,6 @@
 // Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
 // SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#include "modules/dde-shell/ddeshellattached.h"
 #include "modules/dde-shell/ddeshellmanagerinterfacev1.h"
 #include "server-bridge.h"
 #include "seat/helper.h"
@@ -15,6 +16,8 @@ WindowOverlapCheckerInterface *g_checker = nullptr;
 DDEActiveInterface *g_active = nullptr;
 WindowPickerInterface *g_picker = nullptr;
 DDEShellSurfaceInterface *g_shellSurface = nullptr;
+// Stands for a window item carrying the DDEShell attached overlap checker.
+QQuickItem *g_window = nullptr;
 
 }
 
@@ -53,6 +56,24 @@ extern "C" void dde_shell_query_surface_state(void *data)
     state->accept_keyboard_focus = g_shellSurface->acceptKeyboardFocus();
 }
 
+extern "C" void dde_shell_move_window(void *data)
+{
+    const auto *geometry = static_cast<const dde_shell_window_geometry *>(data);
+    if (!g_window) {
+        g_window = new QQuickItem;
+        new WindowOverlapChecker(g_window, g_window);
+    }
+
+    // One change at a time, each one reports the window's rect.
+    if (!geometry->visible) {
+        g_window->setVisible(false);
+        return;
+    }
+    g_window->setSize(QSizeF(geometry->width, geometry->height));
+    g_window->setPosition(QPointF(geometry->x, geometry->y));
+    g_window->setVisible(true);
+}
+
 extern "C" void dde_shell_emit_test_events(void *)
 {
     if (g_checker) {
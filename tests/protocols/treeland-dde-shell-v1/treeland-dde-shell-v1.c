@@ -10,6 +10,7 @@
 #include <string.h>
 
 extern void dde_shell_emit_test_events(void *data);
+extern void dde_shell_move_window(void *data);
 
 struct test_case {
     const char *name;
@@ -73,13 +74,17 @@ int test_print_results(struct test_ctx *ctx)
 static void checker_enter(void *data, struct treeland_window_overlap_checker *checker)
 {
     (void)checker;
-    ((struct test_ctx *)data)->checker_enter_received = 1;
+    struct test_ctx *ctx = data;
+    ctx->checker_enter_received = 1;
+    ++ctx->checker_enter_count;
 }
 
 static void checker_leave(void *data, struct treeland_window_overlap_checker *checker)
 {
     (void)checker;
-    ((struct test_ctx *)data)->checker_leave_received = 1;
+    struct test_ctx *ctx = data;
+    ctx->checker_leave_received = 1;
+    ++ctx->checker_leave_count;
 }
 
 static const struct treeland_window_overlap_checker_listener checker_listener = {
@@ -201,6 +206,49 @@ static int update_checker(struct test_ctx *ctx)
     return 1;
 }
 
+// Moves the server side window, then reads the checker events it caused.
+static int move_window(struct test_ctx *ctx, int x, int y, int visible)
+{
+    struct dde_shell_window_geometry geometry = { x, y, 200, 200, visible };
+    ctx->checker_enter_count = 0;
+    ctx->checker_leave_count = 0;
+    return invoke_on_server_thread(dde_shell_move_window, &geometry)
+           && wl_display_roundtrip(ctx->display) >= 0;
+}
+
+// The checker watches the top 100 px of the output.
+static int window_enters_region(struct test_ctx *ctx)
+{
+    return move_window(ctx, 10, 10, 1)
+           && ctx->checker_enter_count == 1 && ctx->checker_leave_count == 0;
+}
+
+static int window_moves_inside_region(struct test_ctx *ctx)
+{
+    return move_window(ctx, 20, 40, 1)
+           && ctx->checker_enter_count == 0 && ctx->checker_leave_count == 0;
+}
+
+static int window_leaves_region(struct test_ctx *ctx)
+{
+    return move_window(ctx, 20, 500, 1)
+           && ctx->checker_enter_count == 0 && ctx->checker_leave_count == 1;
+}
+
+static int window_moves_outside_region(struct test_ctx *ctx)
+{
+    return move_window(ctx, 40, 400, 1)
+           && ctx->checker_enter_count == 0 && ctx->checker_leave_count == 0;
+}
+
+static int window_hidden_in_region(struct test_ctx *ctx)
+{
+    return move_window(ctx, 10, 10, 1)
+           && ctx->checker_enter_count == 1 && ctx->checker_leave_count == 0
+           && move_window(ctx, 10, 10, 0)
+           && ctx->checker_enter_count == 0 && ctx->checker_leave_count == 1;
+}
+
 static int read_shell_surface_state(struct test_ctx *ctx, struct dde_shell_surface_state *state)
 {
     if (wl_display_roundtrip(ctx->display) < 0)
@@ -314,6 +362,11 @@ static const struct test_case cases[] = {
     { "manager.get_treeland_window_picker", create_picker },
     { "manager.get_treeland_lockscreen", create_lockscreen },
     { "checker.update", update_checker },
+    { "checker.window_enters_region", window_enters_region },
+    { "checker.window_moves_inside_region", window_moves_inside_region },
+    { "checker.window_leaves_region", window_leaves_region },
+    { "checker.window_moves_outside_region", window_moves_outside_region },
+    { "checker.window_hidden_in_region", window_hidden_in_region },
     { "shell_surface.set_surface_position", set_surface_position },
     { "shell_surface.set_role", set_surface_role },
     { "shell_surface.set_auto_placement", set_auto_placement },
@@ -24,6 +24,14 @@ struct dde_shell_surface_state {
     int accept_keyboard_focus;
 };
 
+struct dde_shell_window_geometry {
+    int x;
+    int y;
+    int width;
+    int height;
+    int visible;
+};
+
 struct test_result {
     const char *name;
     int         failed;
@@ -52,6 +60,8 @@ struct test_ctx {
 
     int checker_enter_received;
     int checker_leave_received;
+    int checker_enter_count;
+    int checker_leave_count;
     int active_in_received;
     int active_out_received;
     int start_drag_received;
@@ -0,0 +1,96 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#include "core/rootsurfacecontainer.h"
+#include "core/shellhandler.h"
+#include "output/output.h"
+#include "seat/helper.h"
+#include "server-bridge.h"
+#include "surface/surfacewrapper.h"
+#include "treeland-output-scale-desktop.h"
+
+#include <wbackend.h>
+#include <woutput.h>
+#include <woutputrenderwindow.h>
+#include <wscopedvalue.h>
+#include <wsurface.h>
+
+#include <wlr_all.h>
+
+#include <QEventLoop>
+#include <QPointer>
+#include <QTimer>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+namespace {
+QPointer<SurfaceWrapper> g_wrapper;
+int g_bufferScaleChanges = 0;
+int g_dprChanges = 0;
+qreal g_lastDpr = 0;
+
+void readState(output_scale_state *state)
+{
+    *state = {};
+    auto *surface = g_wrapper ? g_wrapper->surface() : nullptr;
+    state->wrapper_ready = surface ? 1 : 0;
+    state->surface_on_output = surface && !surface->outputs().isEmpty() ? 1 : 0;
+    state->preferred_buffer_scale = surface ? int(surface->preferredBufferScale()) : 0;
+    state->buffer_scale_changes = g_bufferScaleChanges;
+    state->dpr_changes = g_dprChanges;
+    state->last_dpr = g_lastDpr;
+}
+}
+
+void protocol_test_setup(Helper *helper)
+{
+    add_headless_output(helper->backend(), false);
+    QObject::connect(helper->shellHandler(),
+                     &ShellHandler::surfaceWrapperAdded,
+                     helper,
+                     [](SurfaceWrapper *wrapper) {
+                         if (wrapper->type() == SurfaceWrapper::Type::XdgToplevel)
+                             g_wrapper = wrapper;
+                     });
+    QObject::connect(helper->window(),
+                     &WOutputRenderWindow::effectiveDevicePixelRatioChanged,
+                     helper,
+                     [](qreal dpr) {
+                         ++g_dprChanges;
+                         g_lastDpr = dpr;
+                     });
+}
+
+// Waits for the window to be on the output and starts counting from there.
+extern "C" void output_scale_begin(void *data)
+{
+    auto *surface = g_wrapper ? g_wrapper->surface() : nullptr;
+    if (surface) {
+        if (surface->outputs().isEmpty()) {
+            QEventLoop eventLoop;
+            QObject::connect(surface, &WSurface::outputEntered, &eventLoop, &QEventLoop::quit);
+            QTimer::singleShot(5000, &eventLoop, &QEventLoop::quit);
+            eventLoop.exec();
+        }
+        QObject::connect(surface, &WSurface::preferredBufferScaleChanged, surface, [] {
+            ++g_bufferScaleChanges;
+        });
+    }
+    g_bufferScaleChanges = 0;
+    g_dprChanges = 0;
+    readState(static_cast<output_scale_state *>(data));
+}
+
+// Commits the scale on the output like an output configuration does, the
+// scaleChanged signals are emitted from the commit.
+extern "C" void output_scale_set(void *data)
+{
+    auto *request = static_cast<output_scale_request *>(data);
+    auto *output = Helper::instance()->rootSurfaceContainer()->primaryOutput();
+    if (output) {
+        WOutputStateGuard state;
+        wlr_output_state_set_scale(state.get(), float(request->scale));
+        if (!wlr_output_commit_state(output->output()->handle(), state.get()))
+            qWarning("Failed to commit scale %f", request->scale);
+    }
+    readState(&request->state);
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "treeland-output-scale-desktop.h"
+#include "server-bridge-api.h"
+
+#include <stdio.h>
+
+extern void output_scale_begin(void *data);
+extern void output_scale_set(void *data);
+
+static int check_state(const char *step,
+                       const struct output_scale_state *state,
+                       int preferred_buffer_scale,
+                       int buffer_scale_changes,
+                       int dpr_changes,
+                       double last_dpr)
+{
+    if (state->preferred_buffer_scale == preferred_buffer_scale
+        && state->buffer_scale_changes == buffer_scale_changes
+        && state->dpr_changes == dpr_changes
+        && (dpr_changes == 0 || (state->last_dpr > last_dpr - 0.001 && state->last_dpr < last_dpr + 0.001)))
+        return 1;
+
+    fprintf(stderr,
+            "%s: preferred buffer scale %d (expected %d), %d buffer scale changes (expected %d), "
+            "%d dpr changes (expected %d), last dpr %.2f (expected %.2f)\n",
+            step,
+            state->preferred_buffer_scale,
+            preferred_buffer_scale,
+            state->buffer_scale_changes,
+            buffer_scale_changes,
+            state->dpr_changes,
+            dpr_changes,
+            state->last_dpr,
+            last_dpr);
+    return 0;
+}
+
+static int set_scale(struct output_scale_request *request, double scale)
+{
+    request->scale = scale;
+    return invoke_on_server_thread(output_scale_set, request);
+}
+
+int protocol_test_run(const char *socket_name)
+{
+    struct client_connection connection;
+    struct xdg_toplevel_client toplevel = { 0 };
+    struct output_scale_state state = { 0 };
+    struct output_scale_request request = { 0 };
+    int ok = 0;
+
+    if (!client_connect(&connection, socket_name))
+        return 1;
+
+    if (!xdg_toplevel_client_create_with_solid_buffer(&connection, &toplevel, 200, 150, 0xff336699u)
+        || wl_display_roundtrip(connection.display) < 0) {
+        fprintf(stderr, "failed to map the toplevel\n");
+        goto done;
+    }
+
+    if (!invoke_on_server_thread(output_scale_begin, &state))
+        goto done;
+    if (!state.wrapper_ready || !state.surface_on_output) {
+        fprintf(stderr,
+                "the toplevel is not shown, wrapper %d, on output %d\n",
+                state.wrapper_ready,
+                state.surface_on_output);
+        goto done;
+    }
+    if (!check_state("initial", &state, 1, 0, 0, 0))
+        goto done;
+
+    // Committing the scale the output already has is no change for anyone.
+    if (!set_scale(&request, 1.0) || !check_state("same scale", &request.state, 1, 0, 0, 0))
+        goto done;
+
+    if (!set_scale(&request, 2.0) || !check_state("scale up", &request.state, 2, 1, 1, 2.0))
+        goto done;
+    if (!set_scale(&request, 2.0) || !check_state("same scale up", &request.state, 2, 1, 1, 2.0))
+        goto done;
+
+    // Unlike a window leaving an output, the output's own scale going down
+    // applies at once.
+    if (!set_scale(&request, 1.0) || !check_state("scale down", &request.state, 1, 2, 2, 1.0))
+        goto done;
+    if (!set_scale(&request, 1.0) || !check_state("same scale down", &request.state, 1, 2, 2, 1.0))
+        goto done;
+    ok = 1;
+
+done:
+    xdg_toplevel_client_destroy(&toplevel);
+    client_disconnect(&connection);
+    return ok ? 0 : 1;
+}
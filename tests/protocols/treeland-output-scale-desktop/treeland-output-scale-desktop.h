@@ -0,0 +1,23 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "client-connection.h"
+#include "xdg-toplevel-client.h"
+
+// The scale the window's surface and the scene got, and how often they
+// were told about a change since output_scale_begin().
+struct output_scale_state {
+    int wrapper_ready;
+    int surface_on_output;
+    int preferred_buffer_scale;
+    int buffer_scale_changes;
+    int dpr_changes;
+    double last_dpr;
+};
+
+struct output_scale_request {
+    double scale;
+    struct output_scale_state state;
+};
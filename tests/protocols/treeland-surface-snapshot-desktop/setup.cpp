@@ -0,0 +1,142 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#include "core/shellhandler.h"
+#include "seat/helper.h"
+#include "server-bridge.h"
+#include "surface/surfacewrapper.h"
+#include "treeland-surface-snapshot-desktop.h"
+
+#include <wbackend.h>
+#include <woutputrenderwindow.h>
+#include <wsurface.h>
+#include <wsurfaceitem.h>
+#include <wsurfacesnapshot.h>
+
+#include <wlr_all.h>
+
+#include <QEventLoop>
+#include <QPointer>
+#include <QSGImageNode>
+#include <private/qquickitem_p.h>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+namespace {
+QPointer<SurfaceWrapper> g_wrapper;
+QPointer<WSurfaceSnapshot> g_snapshot;
+
+// Tells whether the captured buffer is still alive without touching it.
+struct BufferWatch
+{
+    wl_listener destroy;
+    wlr_buffer *buffer = nullptr;
+} g_captured;
+
+void watchBuffer(wlr_buffer *buffer)
+{
+    if (g_captured.buffer)
+        wl_list_remove(&g_captured.destroy.link);
+    g_captured.buffer = buffer;
+    if (!buffer)
+        return;
+    g_captured.destroy.notify = [](wl_listener *listener, void *) {
+        wl_list_remove(&listener->link);
+        g_captured.buffer = nullptr;
+    };
+    wl_signal_add(&buffer->events.destroy, &g_captured.destroy);
+}
+
+void renderFrame()
+{
+    auto *window = Helper::instance()->window();
+    QEventLoop eventLoop;
+    QObject::connect(window, &WOutputRenderWindow::renderEnd, &eventLoop, &QEventLoop::quit);
+    window->update();
+    eventLoop.exec();
+}
+
+void readState(surface_snapshot_state *state)
+{
+    *state = {};
+    state->wrapper_ready = g_wrapper ? 1 : 0;
+    state->captured_buffer_alive = g_captured.buffer ? 1 : 0;
+    if (g_wrapper && g_wrapper->surface())
+        state->captured_buffer_is_current = g_wrapper->surface()->buffer() == g_captured.buffer ? 1 : 0;
+    if (!g_snapshot)
+        return;
+
+    auto *node = QQuickItemPrivate::get(g_snapshot)->paintNode;
+    if (!node)
+        return;
+    int index = 0;
+    for (auto *child = node->firstChild(); child; child = child->nextSibling(), ++index) {
+        const QRectF rect = static_cast<QSGImageNode *>(child)->rect();
+        if (index == 0) {
+            state->first_x = qRound(rect.x());
+            state->first_y = qRound(rect.y());
+            state->first_width = qRound(rect.width());
+            state->first_height = qRound(rect.height());
+        } else if (index == 1) {
+            state->second_x = qRound(rect.x());
+            state->second_y = qRound(rect.y());
+            state->second_width = qRound(rect.width());
+            state->second_height = qRound(rect.height());
+        }
+    }
+    state->image_count = index;
+}
+}
+
+void protocol_test_setup(Helper *helper)
+{
+    add_headless_output(helper->backend(), false);
+    QObject::connect(helper->shellHandler(),
+                     &ShellHandler::surfaceWrapperAdded,
+                     helper,
+                     [](SurfaceWrapper *wrapper) {
+                         if (wrapper->type() == SurfaceWrapper::Type::XdgToplevel)
+                             g_wrapper = wrapper;
+                     });
+}
+
+// Freezes the window in a SurfaceSnapshot, like the window animations do.
+extern "C" void surface_snapshot_capture(void *data)
+{
+    auto *state = static_cast<surface_snapshot_state *>(data);
+    if (!g_wrapper || !g_wrapper->surfaceItem()) {
+        readState(state);
+        return;
+    }
+
+    auto *sourceItem = g_wrapper->surfaceItem();
+    g_snapshot = new WSurfaceSnapshot(Helper::instance()->window()->contentItem());
+    g_snapshot->setLive(false);
+    g_snapshot->setSourceItem(sourceItem);
+    g_snapshot->setSize(sourceItem->size());
+    watchBuffer(g_wrapper->surface()->buffer());
+    renderFrame();
+    readState(state);
+}
+
+// Captures the current buffers again, like ShaderEffectSource::scheduleUpdate().
+extern "C" void surface_snapshot_recapture(void *data)
+{
+    if (g_snapshot && g_wrapper) {
+        g_snapshot->scheduleUpdate();
+        watchBuffer(g_wrapper->surface()->buffer());
+        renderFrame();
+    }
+    readState(static_cast<surface_snapshot_state *>(data));
+}
+
+extern "C" void surface_snapshot_read_state(void *data)
+{
+    readState(static_cast<surface_snapshot_state *>(data));
+}
+
+extern "C" void surface_snapshot_release(void *data)
+{
+    delete g_snapshot;
+    renderFrame();
+    readState(static_cast<surface_snapshot_state *>(data));
+}
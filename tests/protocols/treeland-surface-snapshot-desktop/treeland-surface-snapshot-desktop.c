@@ -0,0 +1,180 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "treeland-surface-snapshot-desktop.h"
+#include "server-bridge-api.h"
+
+#include <stdio.h>
+
+extern void surface_snapshot_capture(void *data);
+extern void surface_snapshot_recapture(void *data);
+extern void surface_snapshot_read_state(void *data);
+extern void surface_snapshot_release(void *data);
+
+static int check_image(const char *step, int index, int x, int y, int width, int height,
+                       int expected_x, int expected_y, int expected_width, int expected_height)
+{
+    if (x == expected_x && y == expected_y && width == expected_width && height == expected_height)
+        return 1;
+    fprintf(stderr,
+            "%s: image %d is %dx%d at (%d,%d), expected %dx%d at (%d,%d)\n",
+            step, index, width, height, x, y,
+            expected_width, expected_height, expected_x, expected_y);
+    return 0;
+}
+
+// The parent is painted at the origin of the window's surface item and the
+// subsurface at its offset from the parent.
+static int check_paint_order(const char *step, const struct surface_snapshot_state *state, int child_first)
+{
+    if (state->image_count != 2) {
+        fprintf(stderr, "%s: expected 2 images, got %d\n", step, state->image_count);
+        return 0;
+    }
+
+    const int parent_x = child_first ? state->second_x : state->first_x;
+    const int parent_y = child_first ? state->second_y : state->first_y;
+    if (child_first) {
+        return check_image(step, 0, state->first_x, state->first_y,
+                           state->first_width, state->first_height,
+                           parent_x + SURFACE_SNAPSHOT_CHILD_X, parent_y + SURFACE_SNAPSHOT_CHILD_Y,
+                           SURFACE_SNAPSHOT_CHILD_WIDTH, SURFACE_SNAPSHOT_CHILD_HEIGHT)
+            && check_image(step, 1, state->second_x, state->second_y,
+                           state->second_width, state->second_height,
+                           parent_x, parent_y,
+                           SURFACE_SNAPSHOT_PARENT_WIDTH, SURFACE_SNAPSHOT_PARENT_HEIGHT);
+    }
+    return check_image(step, 0, state->first_x, state->first_y,
+                       state->first_width, state->first_height,
+                       parent_x, parent_y,
+                       SURFACE_SNAPSHOT_PARENT_WIDTH, SURFACE_SNAPSHOT_PARENT_HEIGHT)
+        && check_image(step, 1, state->second_x, state->second_y,
+                       state->second_width, state->second_height,
+                       parent_x + SURFACE_SNAPSHOT_CHILD_X, parent_y + SURFACE_SNAPSHOT_CHILD_Y,
+                       SURFACE_SNAPSHOT_CHILD_WIDTH, SURFACE_SNAPSHOT_CHILD_HEIGHT);
+}
+
+int protocol_test_run(const char *socket_name)
+{
+    struct client_connection connection;
+    struct xdg_toplevel_client toplevel = { 0 };
+    struct wl_subcompositor *subcompositor = NULL;
+    struct wl_surface *child = NULL;
+    struct wl_subsurface *subsurface = NULL;
+    struct wl_buffer *child_buffer = NULL;
+    struct surface_snapshot_state state = { 0 };
+    int ok = 0;
+
+    if (!client_connect(&connection, socket_name))
+        return 1;
+
+    subcompositor = client_bind(&connection, "wl_subcompositor", &wl_subcompositor_interface, 1);
+    if (!subcompositor) {
+        fprintf(stderr, "wl_subcompositor is not available\n");
+        goto done;
+    }
+
+    if (!xdg_toplevel_client_create_with_solid_buffer(&connection,
+                                                      &toplevel,
+                                                      SURFACE_SNAPSHOT_PARENT_WIDTH,
+                                                      SURFACE_SNAPSHOT_PARENT_HEIGHT,
+                                                      0xff336699u)) {
+        fprintf(stderr, "failed to map the toplevel\n");
+        goto done;
+    }
+
+    // A synchronized subsurface above the parent, applied by the parent's next commit.
+    child = wl_compositor_create_surface(toplevel.compositor);
+    subsurface = wl_subcompositor_get_subsurface(subcompositor, child, toplevel.surface);
+    child_buffer = client_create_solid_buffer(toplevel.shm,
+                                              SURFACE_SNAPSHOT_CHILD_WIDTH,
+                                              SURFACE_SNAPSHOT_CHILD_HEIGHT,
+                                              0xffcc3333u);
+    if (!child || !subsurface || !child_buffer)
+        goto done;
+    wl_subsurface_set_position(subsurface, SURFACE_SNAPSHOT_CHILD_X, SURFACE_SNAPSHOT_CHILD_Y);
+    wl_surface_attach(child, child_buffer, 0, 0);
+    wl_surface_damage_buffer(child, 0, 0, SURFACE_SNAPSHOT_CHILD_WIDTH, SURFACE_SNAPSHOT_CHILD_HEIGHT);
+    wl_surface_commit(child);
+    if (!xdg_toplevel_client_commit_solid_buffer(&connection,
+                                                 &toplevel,
+                                                 SURFACE_SNAPSHOT_PARENT_WIDTH,
+                                                 SURFACE_SNAPSHOT_PARENT_HEIGHT,
+                                                 0xff336699u)
+        || wl_display_roundtrip(connection.display) < 0)
+        goto done;
+
+    if (!invoke_on_server_thread(surface_snapshot_capture, &state))
+        goto done;
+    if (!state.wrapper_ready) {
+        fprintf(stderr, "the toplevel has no surface wrapper\n");
+        goto done;
+    }
+    if (!check_paint_order("capture", &state, 0))
+        goto done;
+    if (!state.captured_buffer_alive) {
+        fprintf(stderr, "capture: the captured buffer is gone\n");
+        goto done;
+    }
+
+    // Restack the child and replace the parent's buffer, the frozen snapshot
+    // keeps the old buffer alive until it captures again.
+    wl_subsurface_place_below(subsurface, toplevel.surface);
+    if (!xdg_toplevel_client_commit_solid_buffer(&connection,
+                                                 &toplevel,
+                                                 SURFACE_SNAPSHOT_PARENT_WIDTH,
+                                                 SURFACE_SNAPSHOT_PARENT_HEIGHT,
+                                                 0xff669933u)
+        || wl_display_roundtrip(connection.display) < 0)
+        goto done;
+
+    if (!invoke_on_server_thread(surface_snapshot_read_state, &state))
+        goto done;
+    if (!state.captured_buffer_alive || state.captured_buffer_is_current) {
+        fprintf(stderr,
+                "frozen: captured buffer alive %d, current %d, expected a locked old buffer\n",
+                state.captured_buffer_alive,
+                state.captured_buffer_is_current);
+        goto done;
+    }
+    if (!check_paint_order("frozen", &state, 0))
+        goto done;
+
+    if (!invoke_on_server_thread(surface_snapshot_recapture, &state)
+        || !check_paint_order("recapture", &state, 1))
+        goto done;
+    if (!state.captured_buffer_alive || !state.captured_buffer_is_current) {
+        fprintf(stderr, "recapture: the current buffer was not captured\n");
+        goto done;
+    }
+
+    // Replace the buffer once more so the surface no longer holds the captured
+    // one, then releasing the snapshot must free it.
+    if (!xdg_toplevel_client_commit_solid_buffer(&connection,
+                                                 &toplevel,
+                                                 SURFACE_SNAPSHOT_PARENT_WIDTH,
+                                                 SURFACE_SNAPSHOT_PARENT_HEIGHT,
+                                                 0xff993366u)
+        || wl_display_roundtrip(connection.display) < 0)
+        goto done;
+    if (!invoke_on_server_thread(surface_snapshot_release, &state))
+        goto done;
+    if (state.captured_buffer_alive) {
+        fprintf(stderr, "release: the captured buffer is still locked\n");
+        goto done;
+    }
+    ok = 1;
+
+done:
+    if (subsurface)
+        wl_subsurface_destroy(subsurface);
+    if (child)
+        wl_surface_destroy(child);
+    if (child_buffer)
+        wl_buffer_destroy(child_buffer);
+    if (subcompositor)
+        wl_subcompositor_destroy(subcompositor);
+    xdg_toplevel_client_destroy(&toplevel);
+    client_disconnect(&connection);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "client-connection.h"
+#include "xdg-toplevel-client.h"
+
+enum {
+    SURFACE_SNAPSHOT_PARENT_WIDTH = 200,
+    SURFACE_SNAPSHOT_PARENT_HEIGHT = 150,
+    SURFACE_SNAPSHOT_CHILD_X = 20,
+    SURFACE_SNAPSHOT_CHILD_Y = 10,
+    SURFACE_SNAPSHOT_CHILD_WIDTH = 40,
+    SURFACE_SNAPSHOT_CHILD_HEIGHT = 30,
+};
+
+// The image nodes of a frozen SurfaceSnapshot of the window, in paint order,
+// and whether the buffer it captured is still alive.
+struct surface_snapshot_state {
+    int wrapper_ready;
+    int image_count;
+    int first_x;
+    int first_y;
+    int first_width;
+    int first_height;
+    int second_x;
+    int second_y;
+    int second_width;
+    int second_height;
+    int captured_buffer_alive;
+    int captured_buffer_is_current;
+};
@@ -0,0 +1,280 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#include "seat/helper.h"
+#include "server-bridge.h"
+#include "synthetictrace.h"
+#include "treeland-trace-replay-desktop.h"
+#include "utils/tracerecorder.h"
+
+#include <wbackend.h>
+#include <wcursor.h>
+#include <woutputlayout.h>
+#include <woutputrenderwindow.h>
+#include <wseat.h>
+
+#include <wlr_all.h>
+#include <wlr/interfaces/wlr_pointer.h>
+#include <wlr/interfaces/wlr_touch.h>
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <linux/input-event-codes.h>
+#include <vector>
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+using TraceFormat::Record;
+using TraceFormat::RecordType;
+
+static_assert(TRACE_REPLAY_POINTER_MOTION == int(RecordType::PointerMotion));
+static_assert(TRACE_REPLAY_KEY == int(RecordType::Key));
+static_assert(TRACE_REPLAY_OUTPUT_FRAME == int(RecordType::OutputFrame));
+
+namespace {
+const wlr_pointer_impl g_pointerImpl = { .name = "trace-replay-pointer" };
+const wlr_keyboard_impl g_keyboardImpl = { .name = "trace-replay-keyboard", .led_update = nullptr };
+const wlr_touch_impl g_touchImpl = { .name = "trace-replay-touch" };
+
+QList<Record> g_records;
+wlr_pointer g_pointer;
+wlr_keyboard g_keyboard;
+wlr_touch g_touch;
+
+QElapsedTimer g_clock;
+// What each frame cost from beforeRendering to renderEnd, idle time between
+// frames doesn't count.
+std::vector<double> g_frameCosts;
+qint64 g_frameStart = -1;
+bool g_measuring = false;
+
+uint32_t buttonCode(quint32 qtButton)
+{
+    switch (qtButton) {
+    case Qt::LeftButton:
+        return BTN_LEFT;
+    case Qt::RightButton:
+        return BTN_RIGHT;
+    case Qt::MiddleButton:
+        return BTN_MIDDLE;
+    case Qt::BackButton:
+        return BTN_SIDE;
+    case Qt::ForwardButton:
+        return BTN_EXTRA;
+    default:
+        return 0;
+    }
+}
+
+// Touch events carry positions normalized to the layout box.
+QPointF touchPosition(const trace_replay_record &record)
+{
+    auto *layout = Helper::instance()->seat()->cursor()->layout();
+    wlr_box box{};
+    wlr_output_layout_get_box(layout->handle(), nullptr, &box);
+    if (box.width <= 0 || box.height <= 0)
+        return {};
+    return QPointF((record.a / 256.0 - box.x) / box.width, (record.b / 256.0 - box.y) / box.height);
+}
+
+double percentile(const std::vector<double> &sorted, int p)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[(sorted.size() - 1) * p / 100];
+}
+}
+
+void protocol_test_setup(Helper *helper)
+{
+    const QString fileName = qEnvironmentVariable("TREELAND_REPLAY_TRACE");
+    if (!fileName.isEmpty()) {
+        QString error;
+        if (!TraceFormat::load(fileName, &g_records, &error))
+            qCritical("Failed to load trace %s: %s", qPrintable(fileName), qPrintable(error));
+    } else {
+        g_records = SyntheticTrace::generate();
+    }
+
+    add_headless_output(helper->backend(), false);
+
+    // Announce the devices like a backend does, so they take the production
+    // path: InputManager attaches them to the seat and the cursor.
+    auto *backend = helper->backend()->handle();
+    wlr_pointer_init(&g_pointer, &g_pointerImpl, g_pointerImpl.name);
+    wl_signal_emit_mutable(&backend->events.new_input, &g_pointer.base);
+    wlr_keyboard_init(&g_keyboard, &g_keyboardImpl, g_keyboardImpl.name);
+    wl_signal_emit_mutable(&backend->events.new_input, &g_keyboard.base);
+    wlr_touch_init(&g_touch, &g_touchImpl, g_touchImpl.name);
+    wl_signal_emit_mutable(&backend->events.new_input, &g_touch.base);
+
+    QObject::connect(helper->window(), &WOutputRenderWindow::beforeRendering, helper, [] {
+        g_frameStart = g_measuring ? g_clock.nsecsElapsed() : -1;
+    });
+    QObject::connect(helper->window(), &WOutputRenderWindow::renderEnd, helper, [] {
+        if (g_measuring && g_frameStart >= 0)
+            g_frameCosts.push_back((g_clock.nsecsElapsed() - g_frameStart) / 1e6);
+        g_frameStart = -1;
+    });
+}
+
+extern "C" void trace_replay_read_records(void *data)
+{
+    auto *records = static_cast<trace_replay_records *>(data);
+    if (!records->records) {
+        records->count = int(g_records.size());
+        return;
+    }
+    const int count = std::min(records->count, int(g_records.size()));
+    for (int i = 0; i < count; ++i) {
+        const Record &record = g_records.at(i);
+        records->records[i] = {
+            .timestamp = record.timestamp,
+            .type = record.type,
+            .id = record.id,
+            .a = record.a,
+            .b = record.b,
+        };
+    }
+    records->count = count;
+}
+
+extern "C" void trace_replay_begin(void *)
+{
+    g_frameCosts.clear();
+    g_frameStart = -1;
+    g_clock.start();
+    g_measuring = true;
+}
+
+extern "C" void trace_replay_inject(void *data)
+{
+    const auto &record = *static_cast<const trace_replay_record *>(data);
+    const uint32_t time = uint32_t(record.timestamp / 1000000);
+
+    switch (record.type) {
+    case TRACE_REPLAY_POINTER_MOTION: {
+        // The trace has absolute positions, move the cursor by the difference
+        // so no pointer acceleration is involved.
+        const QPointF target(record.a / 256.0, record.b / 256.0);
+        const QPointF delta = target - Helper::instance()->seat()->cursor()->position();
+        wlr_pointer_motion_event event = {
+            .pointer = &g_pointer,
+            .time_msec = time,
+            .delta_x = delta.x(),
+            .delta_y = delta.y(),
+            .unaccel_dx = delta.x(),
+            .unaccel_dy = delta.y(),
+        };
+        wl_signal_emit_mutable(&g_pointer.events.motion, &event);
+        wl_signal_emit_mutable(&g_pointer.events.frame, &g_pointer);
+        break;
+    }
+    case TRACE_REPLAY_POINTER_BUTTON: {
+        const uint32_t button = buttonCode(record.id);
+        if (!button)
+            break;
+        wlr_pointer_button_event event = {
+            .pointer = &g_pointer,
+            .time_msec = time,
+            .button = button,
+            .state = record.a ? WL_POINTER_BUTTON_STATE_PRESSED : WL_POINTER_BUTTON_STATE_RELEASED,
+        };
+        wlr_pointer_notify_button(&g_pointer, &event);
+        wl_signal_emit_mutable(&g_pointer.events.frame, &g_pointer);
+        break;
+    }
+    case TRACE_REPLAY_POINTER_AXIS: {
+        // Qt's angle delta is 120 per wheel notch and positive away from the
+        // user, wl_pointer scrolls down for positive values, 15 per notch.
+        wlr_pointer_axis_event event = {
+            .pointer = &g_pointer,
+            .time_msec = time,
+            .source = WL_POINTER_AXIS_SOURCE_WHEEL,
+            .orientation = record.id == Qt::Horizontal ? WL_POINTER_AXIS_HORIZONTAL_SCROLL
+                                                       : WL_POINTER_AXIS_VERTICAL_SCROLL,
+            .relative_direction = WL_POINTER_AXIS_RELATIVE_DIRECTION_IDENTICAL,
+            .delta = -record.a * 15.0 / 120,
+            .delta_discrete = -record.a,
+        };
+        wl_signal_emit_mutable(&g_pointer.events.axis, &event);
+        wl_signal_emit_mutable(&g_pointer.events.frame, &g_pointer);
+        break;
+    }
+    case TRACE_REPLAY_KEY: {
+        wlr_keyboard_key_event event = {
+            .time_msec = time,
+            .keycode = record.id,
+            .update_state = true,
+            .state = record.a ? WL_KEYBOARD_KEY_STATE_PRESSED : WL_KEYBOARD_KEY_STATE_RELEASED,
+        };
+        wlr_keyboard_notify_key(&g_keyboard, &event);
+        break;
+    }
+    case TRACE_REPLAY_TOUCH_DOWN:
+    case TRACE_REPLAY_TOUCH_MOTION: {
+        const QPointF pos = touchPosition(record);
+        if (record.type == TRACE_REPLAY_TOUCH_DOWN) {
+            wlr_touch_down_event event = {
+                .touch = &g_touch,
+                .time_msec = time,
+                .touch_id = int32_t(record.id),
+                .x = pos.x(),
+                .y = pos.y(),
+            };
+            wl_signal_emit_mutable(&g_touch.events.down, &event);
+        } else {
+            wlr_touch_motion_event event = {
+                .touch = &g_touch,
+                .time_msec = time,
+                .touch_id = int32_t(record.id),
+                .x = pos.x(),
+                .y = pos.y(),
+            };
+            wl_signal_emit_mutable(&g_touch.events.motion, &event);
+        }
+        wl_signal_emit_mutable(&g_touch.events.frame, nullptr);
+        break;
+    }
+    case TRACE_REPLAY_TOUCH_UP: {
+        wlr_touch_up_event event = {
+            .touch = &g_touch,
+            .time_msec = time,
+            .touch_id = int32_t(record.id),
+        };
+        wl_signal_emit_mutable(&g_touch.events.up, &event);
+        wl_signal_emit_mutable(&g_touch.events.frame, nullptr);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+extern "C" void trace_replay_finish(void *data)
+{
+    g_measuring = false;
+
+    std::vector<double> costs = g_frameCosts;
+    std::sort(costs.begin(), costs.end());
+
+    bool ok = false;
+    double maxP99 = qEnvironmentVariable("TREELAND_REPLAY_MAX_P99_MS").toDouble(&ok);
+    if (!ok || maxP99 <= 0)
+        maxP99 = 100;
+
+    auto *result = static_cast<trace_replay_result *>(data);
+    *result = {
+        .frames = int(costs.size()),
+        .p50_ms = percentile(costs, 50),
+        .p99_ms = percentile(costs, 99),
+        .max_ms = costs.empty() ? 0.0 : costs.back(),
+        .max_p99_ms = maxP99,
+    };
+    qInfo("Replayed frame cost: %d frames, p50 %.2f ms, p99 %.2f ms, max %.2f ms (p99 limit %.2f ms)",
+          result->frames,
+          result->p50_ms,
+          result->p99_ms,
+          result->max_ms,
+          result->max_p99_ms);
+}
@@ -0,0 +1,191 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "treeland-trace-replay-desktop.h"
+#include "server-bridge-api.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern void trace_replay_read_records(void *data);
+extern void trace_replay_begin(void *data);
+extern void trace_replay_inject(void *data);
+extern void trace_replay_finish(void *data);
+
+enum { TRACE_REPLAY_MAX_SURFACES = 64 };
+
+// Slots stay in place while used: the xdg listeners point into them.
+struct replayed_surface {
+    int used;
+    uint32_t trace_id;
+    uint32_t commits;
+    struct xdg_toplevel_client toplevel;
+};
+
+struct replay_client {
+    struct client_connection *connection;
+    struct replayed_surface surfaces[TRACE_REPLAY_MAX_SURFACES];
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t deadline)
+{
+    const uint64_t now = now_ns();
+    if (now >= deadline)
+        return;
+    const uint64_t remaining = deadline - now;
+    struct timespec ts = {
+        .tv_sec = (time_t)(remaining / 1000000000ull),
+        .tv_nsec = (long)(remaining % 1000000000ull),
+    };
+    nanosleep(&ts, NULL);
+}
+
+static struct replayed_surface *find_surface(struct replay_client *client, uint32_t trace_id)
+{
+    for (int i = 0; i < TRACE_REPLAY_MAX_SURFACES; ++i) {
+        if (client->surfaces[i].used && client->surfaces[i].trace_id == trace_id)
+            return &client->surfaces[i];
+    }
+    return NULL;
+}
+
+// Every commit gets a differently colored buffer of the recorded size, so the
+// compositor really uploads and repaints it like a client's new frame.
+static int replay_commit(struct replay_client *client, const struct trace_replay_record *record)
+{
+    const int width = record->a > 0 ? record->a : 1;
+    const int height = record->b > 0 ? record->b : 1;
+    struct replayed_surface *surface = find_surface(client, record->id);
+    if (!surface) {
+        for (int i = 0; i < TRACE_REPLAY_MAX_SURFACES && !surface; ++i) {
+            if (!client->surfaces[i].used)
+                surface = &client->surfaces[i];
+        }
+        // Surfaces beyond the table are dropped, their input still replays.
+        if (!surface)
+            return 1;
+        memset(surface, 0, sizeof(*surface));
+        if (!xdg_toplevel_client_create_with_solid_buffer(client->connection,
+                                                          &surface->toplevel,
+                                                          width,
+                                                          height,
+                                                          0xff336699u))
+            return 0;
+        surface->used = 1;
+        surface->trace_id = record->id;
+        return 1;
+    }
+
+    ++surface->commits;
+    const uint32_t shade = (surface->commits * 4) & 0xff;
+    return xdg_toplevel_client_ack_latest_configure(client->connection, &surface->toplevel)
+        && xdg_toplevel_client_commit_solid_buffer(client->connection,
+                                                   &surface->toplevel,
+                                                   width,
+                                                   height,
+                                                   0xff000000u | (shade << 16) | (0x66u << 8) | (0xffu - shade));
+}
+
+static void replay_destroy(struct replay_client *client, uint32_t trace_id)
+{
+    struct replayed_surface *surface = find_surface(client, trace_id);
+    if (!surface)
+        return;
+    xdg_toplevel_client_destroy(&surface->toplevel);
+    surface->used = 0;
+    wl_display_flush(client->connection->display);
+}
+
+int protocol_test_run(const char *socket_name)
+{
+    struct client_connection connection;
+    struct replay_client client = { .connection = &connection };
+    struct trace_replay_records records = { 0 };
+    struct trace_replay_result result = { 0 };
+    uint64_t start;
+    uint64_t first;
+    int ok = 0;
+
+    if (!client_connect(&connection, socket_name))
+        return 1;
+
+    if (!invoke_on_server_thread(trace_replay_read_records, &records) || records.count <= 0) {
+        fprintf(stderr, "trace replay: no records to replay\n");
+        goto done;
+    }
+    records.records = calloc((size_t)records.count, sizeof(*records.records));
+    if (!records.records || !invoke_on_server_thread(trace_replay_read_records, &records))
+        goto done;
+
+    if (!invoke_on_server_thread(trace_replay_begin, NULL))
+        goto done;
+
+    start = now_ns();
+    first = records.records[0].timestamp;
+    for (int i = 0; i < records.count; ++i) {
+        const struct trace_replay_record *record = &records.records[i];
+        if (record->timestamp > first)
+            sleep_until(start + (record->timestamp - first));
+
+        switch (record->type) {
+        case TRACE_REPLAY_SURFACE_COMMIT:
+            if (!replay_commit(&client, record)) {
+                fprintf(stderr, "trace replay: commit of surface %u failed\n", record->id);
+                goto done;
+            }
+            break;
+        case TRACE_REPLAY_SURFACE_DESTROY:
+            replay_destroy(&client, record->id);
+            break;
+        case TRACE_REPLAY_OUTPUT_FRAME:
+            // Output frames are what the replay measures, not an input.
+            break;
+        default:
+            if (!invoke_on_server_thread(trace_replay_inject, (void *)record))
+                goto done;
+            break;
+        }
+        if (wl_display_dispatch_pending(connection.display) < 0)
+            goto done;
+    }
+
+    // Let the last commits reach the screen.
+    sleep_until(now_ns() + 100000000ull);
+    if (wl_display_roundtrip(connection.display) < 0
+        || !invoke_on_server_thread(trace_replay_finish, &result))
+        goto done;
+
+    if (result.frames < 2) {
+        fprintf(stderr, "trace replay: only %d frames rendered\n", result.frames);
+        goto done;
+    }
+    if (result.p99_ms > result.max_p99_ms) {
+        fprintf(stderr,
+                "trace replay: p99 frame cost %.2f ms exceeds %.2f ms\n",
+                result.p99_ms,
+                result.max_p99_ms);
+        goto done;
+    }
+    ok = 1;
+
+done:
+    for (int i = 0; i < TRACE_REPLAY_MAX_SURFACES; ++i) {
+        if (client.surfaces[i].used)
+            xdg_toplevel_client_destroy(&client.surfaces[i].toplevel);
+    }
+    free(records.records);
+    client_disconnect(&connection);
+    return ok ? 0 : 1;
+}
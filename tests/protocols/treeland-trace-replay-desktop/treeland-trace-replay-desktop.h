@@ -0,0 +1,45 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include "client-connection.h"
+#include "xdg-toplevel-client.h"
+
+#include <stdint.h>
+
+// Mirrors TraceFormat::RecordType from src/utils/tracerecorder.h.
+enum trace_replay_record_type {
+    TRACE_REPLAY_POINTER_MOTION = 1,
+    TRACE_REPLAY_POINTER_BUTTON,
+    TRACE_REPLAY_POINTER_AXIS,
+    TRACE_REPLAY_KEY,
+    TRACE_REPLAY_TOUCH_DOWN,
+    TRACE_REPLAY_TOUCH_MOTION,
+    TRACE_REPLAY_TOUCH_UP,
+    TRACE_REPLAY_SURFACE_COMMIT,
+    TRACE_REPLAY_SURFACE_DESTROY,
+    TRACE_REPLAY_OUTPUT_FRAME,
+};
+
+struct trace_replay_record {
+    uint64_t timestamp;
+    uint32_t type;
+    uint32_t id;
+    int32_t a;
+    int32_t b;
+};
+
+struct trace_replay_records {
+    struct trace_replay_record *records;
+    int count;
+};
+
+// Percentiles of the per-frame cost, from beforeRendering to renderEnd.
+struct trace_replay_result {
+    int frames;
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+    double max_p99_ms;
+};
@@ -0,0 +1,93 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "input/motionpredictor.h"
+
+#include <QObject>
+#include <QTest>
+
+class MotionPredictorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testDisabledByDefault()
+    {
+        MotionPredictor predictor;
+        predictor.addSample(QPointF(0, 0), 100);
+        predictor.addSample(QPointF(10, 0), 108);
+        QCOMPARE(predictor.predicted(), QPointF(10, 0));
+    }
+
+    void testConstantVelocity()
+    {
+        MotionPredictor predictor;
+        predictor.setLookahead(16);
+        // 1 px/ms to the right, 0.5 px/ms down, sampled every 8 ms.
+        for (int i = 0; i < 10; ++i)
+            predictor.addSample(QPointF(i * 8, i * 4), 1000 + i * 8);
+
+        QCOMPARE(predictor.position(), QPointF(72, 36));
+        const QPointF predicted = predictor.predicted();
+        QVERIFY(qAbs(predicted.x() - 88) < 0.1);
+        QVERIFY(qAbs(predicted.y() - 44) < 0.1);
+    }
+
+    void testDirectionChange()
+    {
+        MotionPredictor predictor;
+        predictor.setLookahead(10);
+        predictor.addSample(QPointF(0, 0), 0);
+        predictor.addSample(QPointF(10, 0), 10);
+        predictor.addSample(QPointF(20, 0), 20);
+        // Turning back follows the new direction at once, no overshoot.
+        predictor.addSample(QPointF(15, 0), 30);
+        QCOMPARE(predictor.predicted(), QPointF(10, 0));
+    }
+
+    void testStoppedFinger()
+    {
+        MotionPredictor predictor;
+        predictor.setLookahead(10);
+        predictor.addSample(QPointF(0, 0), 0);
+        predictor.addSample(QPointF(10, 0), 10);
+        // Too long since the last sample, the finger stopped in between.
+        predictor.addSample(QPointF(12, 0), 200);
+        QCOMPARE(predictor.predicted(), QPointF(12, 0));
+    }
+
+    void testReset()
+    {
+        MotionPredictor predictor;
+        predictor.setLookahead(10);
+        predictor.addSample(QPointF(0, 0), 0);
+        predictor.addSample(QPointF(10, 0), 10);
+        QVERIFY(predictor.hasSample());
+
+        predictor.reset();
+        QVERIFY(!predictor.hasSample());
+        // A new touch doesn't inherit the velocity of the previous one.
+        predictor.addSample(QPointF(100, 100), 20);
+        QCOMPARE(predictor.predicted(), QPointF(100, 100));
+        predictor.addSample(QPointF(100, 110), 30);
+        QCOMPARE(predictor.predicted(), QPointF(100, 115));
+    }
+
+    void testLookaheadClamp()
+    {
+        MotionPredictor predictor;
+        predictor.setLookahead(-5);
+        QCOMPARE(predictor.lookahead(), 0);
+        predictor.setLookahead(1000);
+        QCOMPARE(predictor.lookahead(), 50);
+
+        predictor.addSample(QPointF(0, 0), 0);
+        predictor.addSample(QPointF(0, 10), 10);
+        // The velocity is halfway to 1 px/ms after one interval, predicted 50 ms ahead.
+        QCOMPARE(predictor.predicted(), QPointF(0, 35));
+    }
+};
+
+QTEST_MAIN(MotionPredictorTest)
+#include "main.moc"
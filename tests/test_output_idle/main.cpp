@@ -0,0 +1,66 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "output/outputidlemanager.h"
+
+#include <QObject>
+#include <QTest>
+
+using State = OutputIdleManager::State;
+
+constexpr qint64 Disabled = 0;
+constexpr qint64 FiveMinutes = 300000;
+constexpr qint64 TenMinutes = 600000;
+
+class OutputIdleTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void testDisabledByDefault()
+    {
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Active, 0, 0), Disabled);
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Idle, 0, 0), Disabled);
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Off, 0, 0), Disabled);
+    }
+
+    void testIdleThenOff()
+    {
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Active, FiveMinutes, TenMinutes), FiveMinutes);
+        QCOMPARE(OutputIdleManager::nextState(State::Active, FiveMinutes), State::Idle);
+        // The power off timeout counts from the last input too, not from going idle.
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Idle, FiveMinutes, TenMinutes), TenMinutes);
+        QCOMPARE(OutputIdleManager::nextState(State::Idle, FiveMinutes), State::Off);
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Off, FiveMinutes, TenMinutes), Disabled);
+    }
+
+    void testIdleOnly()
+    {
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Active, FiveMinutes, 0), FiveMinutes);
+        QCOMPARE(OutputIdleManager::nextState(State::Active, FiveMinutes), State::Idle);
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Idle, FiveMinutes, 0), Disabled);
+    }
+
+    void testPowerOffOnly()
+    {
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Active, 0, TenMinutes), TenMinutes);
+        QCOMPARE(OutputIdleManager::nextState(State::Active, 0), State::Off);
+    }
+
+    void testPowerOffShorterThanIdle()
+    {
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Active, TenMinutes, FiveMinutes), TenMinutes);
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Idle, TenMinutes, FiveMinutes), TenMinutes);
+    }
+
+    void testNegativeTimeoutsAreDisabled()
+    {
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Active, -1, -1), Disabled);
+        QCOMPARE(OutputIdleManager::nextDeadline(State::Idle, -1, -1), Disabled);
+        QCOMPARE(OutputIdleManager::nextState(State::Active, -1), State::Off);
+    }
+};
+
+QTEST_MAIN(OutputIdleTest)
+#include "main.moc"
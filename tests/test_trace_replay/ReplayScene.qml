@@ -0,0 +1,59 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+import QtQuick
+
+// Stands in for the client surfaces of a recorded trace: every surface
+// becomes a rectangle sized to its buffer, every commit changes its color so
+// the item is really re-rendered, like a client's new buffer would be.
+Item {
+    id: root
+
+    property var surfaces: ({})
+
+    Component {
+        id: surfaceComponent
+
+        Rectangle {
+            property int commits: 0
+            color: Qt.hsla((commits % 64) / 64, 0.5, 0.5, 1)
+        }
+    }
+
+    function commitSurface(id, width, height) {
+        let surface = surfaces[id]
+        if (!surface) {
+            const count = Object.keys(surfaces).length
+            surface = surfaceComponent.createObject(root, {
+                x: (count * 48) % Math.max(1, root.width - width),
+                y: (count * 32) % Math.max(1, root.height - height)
+            })
+            surfaces[id] = surface
+        }
+        surface.width = width
+        surface.height = height
+        surface.commits++
+    }
+
+    function destroySurface(id) {
+        const surface = surfaces[id]
+        if (surface) {
+            surface.destroy()
+            delete surfaces[id]
+        }
+    }
+
+    function moveCursor(x, y) {
+        cursor.x = x
+        cursor.y = y
+    }
+
+    Rectangle {
+        id: cursor
+        z: 1
+        width: 24
+        height: 24
+        radius: 12
+        color: "white"
+    }
+}
@@ -0,0 +1,40 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+import QtQuick
+import Waylib.Server
+import TestTraceReplay
+
+Item {
+    id: root
+
+    OutputRenderWindow {
+        id: renderWindow
+        objectName: "renderWindow"
+        width: 1280
+        height: 800
+
+        DynamicCreatorComponent {
+            creator: TestHelper.outputCreator
+
+            OutputItem {
+                id: outputItem
+                required property WaylandOutput waylandOutput
+                output: waylandOutput
+                devicePixelRatio: waylandOutput.scale
+
+                OutputViewport {
+                    id: outputViewport
+                    output: waylandOutput
+                    devicePixelRatio: parent.devicePixelRatio
+                    anchors.centerIn: parent
+                }
+
+                ReplayScene {
+                    objectName: "replayScene"
+                    anchors.fill: parent
+                }
+            }
+        }
+    }
+}
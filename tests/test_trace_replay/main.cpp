@@ -0,0 +1,326 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <algorithm>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPointingDevice>
+#include <QQmlApplicationEngine>
+#include <QQuickItem>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTouchEvent>
+#include <QWheelEvent>
+
+#include <woutputrenderwindow.h>
+#include <wlr_all.h>
+#include <wserver.h>
+#include <wrenderhelper.h>
+#include <wlogging.h>
+
+#include "TestHelper.h"
+#include "synthetictrace.h"
+#include "utils/tracerecorder.h"
+
+WAYLIB_SERVER_USE_NAMESPACE
+
+using TraceFormat::Record;
+using TraceFormat::RecordType;
+
+/// Replays a trace recorded by treeland (TREELAND_TRACE_FILE=<path>) on the
+/// headless backend and prints the frame interval and frame cost percentiles,
+/// so a jank report can be turned into a reproducible before/after measurement.
+///
+/// Set TREELAND_REPLAY_TRACE=<path> to replay a recorded trace, without it a
+/// small synthetic trace is generated. Commits are replayed on plain scene
+/// items sized to the recorded buffers, the pointer moves a cursor item. The
+/// replay fails when the p99 frame cost, from beforeRendering to renderEnd,
+/// exceeds TREELAND_REPLAY_MAX_P99_MS (default 100 ms). Idle gaps between
+/// frames are not part of the cost. For a replay through real
+/// clients and input devices see tests/protocols/treeland-trace-replay-desktop.
+class TraceReplayTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void setGlobals(WOutputRenderWindow *w, QQuickItem *s)
+    {
+        m_window = w;
+        m_scene = s;
+    }
+
+private:
+    static inline WOutputRenderWindow *m_window = nullptr;
+    static inline QQuickItem *m_scene = nullptr;
+
+    QTemporaryDir m_tempDir;
+    QList<Record> m_records;
+
+    static double percentile(const std::vector<double> &sorted, int p)
+    {
+        if (sorted.empty())
+            return 0;
+        return sorted[(sorted.size() - 1) * p / 100];
+    }
+
+    static double report(const char *name, std::vector<double> intervals)
+    {
+        std::sort(intervals.begin(), intervals.end());
+        qDebug("%s: %zu frames, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms",
+               name,
+               intervals.size(),
+               percentile(intervals, 50),
+               percentile(intervals, 90),
+               percentile(intervals, 99),
+               intervals.empty() ? 0.0 : intervals.back());
+        return percentile(intervals, 99);
+    }
+
+    void dispatch(const Record &record)
+    {
+        switch (RecordType(record.type)) {
+        case RecordType::PointerMotion:
+            QMetaObject::invokeMethod(m_scene,
+                                      "moveCursor",
+                                      Q_ARG(QVariant, record.a / 256.0),
+                                      Q_ARG(QVariant, record.b / 256.0));
+            break;
+        case RecordType::SurfaceCommit:
+            QMetaObject::invokeMethod(m_scene,
+                                      "commitSurface",
+                                      Q_ARG(QVariant, record.id),
+                                      Q_ARG(QVariant, std::max(record.a, 1)),
+                                      Q_ARG(QVariant, std::max(record.b, 1)));
+            break;
+        case RecordType::SurfaceDestroy:
+            QMetaObject::invokeMethod(m_scene, "destroySurface", Q_ARG(QVariant, record.id));
+            break;
+        default:
+            // Buttons, keys and touch don't change the replayed scene.
+            break;
+        }
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QVERIFY(m_tempDir.isValid());
+
+        const QString fileName = qEnvironmentVariable("TREELAND_REPLAY_TRACE");
+        QString error;
+        if (!fileName.isEmpty()) {
+            QVERIFY2(TraceFormat::load(fileName, &m_records, &error), qPrintable(error));
+        } else {
+            m_records = SyntheticTrace::generate();
+        }
+        QVERIFY(!m_records.isEmpty());
+    }
+
+    void formatRoundTrip()
+    {
+        const QString fileName = m_tempDir.filePath("roundtrip.trace");
+        QString error;
+        QVERIFY2(TraceFormat::save(fileName, m_records, &error), qPrintable(error));
+
+        QList<Record> loaded;
+        QVERIFY2(TraceFormat::load(fileName, &loaded, &error), qPrintable(error));
+        QCOMPARE(loaded.size(), m_records.size());
+        for (qsizetype i = 0; i < loaded.size(); ++i) {
+            QCOMPARE(loaded[i].timestamp, m_records[i].timestamp);
+            QCOMPARE(loaded[i].type, m_records[i].type);
+            QCOMPARE(loaded[i].id, m_records[i].id);
+            QCOMPARE(loaded[i].a, m_records[i].a);
+            QCOMPARE(loaded[i].b, m_records[i].b);
+        }
+    }
+
+    void rejectsForeignFile()
+    {
+        const QString fileName = m_tempDir.filePath("foreign.trace");
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("definitely not a trace file");
+        file.close();
+
+        QList<Record> loaded;
+        QVERIFY(!TraceFormat::load(fileName, &loaded));
+    }
+
+    void recorderWritesInput()
+    {
+        const QString fileName = m_tempDir.filePath("recorded.trace");
+        {
+            TraceRecorder recorder;
+            QVERIFY(recorder.open(fileName));
+
+            // WSeat sends the xkb keycode as native scan code and the evdev
+            // keycode as native virtual key, KEY_A is 30.
+            QKeyEvent press(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier, 38, 30, 0);
+            QKeyEvent release(QEvent::KeyRelease, Qt::Key_A, Qt::NoModifier, 38, 30, 0);
+            recorder.recordInput(&press);
+            recorder.recordInput(&release);
+
+            const QPointF pos(12.5, 40.25);
+            QMouseEvent move(QEvent::MouseMove, pos, pos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+            QMouseEvent click(QEvent::MouseButtonPress, pos, pos, Qt::RightButton, Qt::RightButton, Qt::NoModifier);
+            recorder.recordInput(&move);
+            recorder.recordInput(&click);
+
+            QWheelEvent wheel(pos, pos, QPoint(), QPoint(0, -120), Qt::NoButton, Qt::NoModifier,
+                              Qt::NoScrollPhase, false);
+            recorder.recordInput(&wheel);
+
+            const QList<QEventPoint> points{ QEventPoint(3, QEventPoint::Pressed, pos, pos) };
+            QTouchEvent touch(QEvent::TouchBegin, QPointingDevice::primaryPointingDevice(),
+                              Qt::NoModifier, points);
+            recorder.recordInput(&touch);
+        }
+
+        QList<Record> loaded;
+        QString error;
+        QVERIFY2(TraceFormat::load(fileName, &loaded, &error), qPrintable(error));
+        QCOMPARE(loaded.size(), 6);
+
+        QCOMPARE(RecordType(loaded[0].type), RecordType::Key);
+        QCOMPARE(loaded[0].id, 30u);
+        QCOMPARE(loaded[0].a, 1);
+        QCOMPARE(loaded[0].b, qint32(Qt::Key_A));
+        QCOMPARE(RecordType(loaded[1].type), RecordType::Key);
+        QCOMPARE(loaded[1].id, 30u);
+        QCOMPARE(loaded[1].a, 0);
+
+        QCOMPARE(RecordType(loaded[2].type), RecordType::PointerMotion);
+        QCOMPARE(loaded[2].a, qRound(12.5 * 256));
+        QCOMPARE(loaded[2].b, qRound(40.25 * 256));
+        QCOMPARE(RecordType(loaded[3].type), RecordType::PointerButton);
+        QCOMPARE(loaded[3].id, quint32(Qt::RightButton));
+        QCOMPARE(loaded[3].a, 1);
+
+        QCOMPARE(RecordType(loaded[4].type), RecordType::PointerAxis);
+        QCOMPARE(loaded[4].id, quint32(Qt::Vertical));
+        QCOMPARE(loaded[4].a, -120);
+
+        QCOMPARE(RecordType(loaded[5].type), RecordType::TouchDown);
+        QCOMPARE(loaded[5].id, 3u);
+        QCOMPARE(loaded[5].a, qRound(12.5 * 256));
+
+        for (qsizetype i = 1; i < loaded.size(); ++i)
+            QVERIFY(loaded[i].timestamp >= loaded[i - 1].timestamp);
+    }
+
+    void replay()
+    {
+        std::vector<double> recordedIntervals;
+        QHash<quint32, quint64> lastRecordedFrame;
+        for (const Record &record : std::as_const(m_records)) {
+            if (RecordType(record.type) != RecordType::OutputFrame)
+                continue;
+            auto it = lastRecordedFrame.find(record.id);
+            if (it != lastRecordedFrame.end())
+                recordedIntervals.push_back((record.timestamp - *it) / 1e6);
+            lastRecordedFrame[record.id] = record.timestamp;
+        }
+
+        QElapsedTimer clock;
+        std::vector<qint64> frameTimes;
+        std::vector<double> frameCosts;
+        qint64 frameStart = -1;
+        auto startConnection = connect(m_window, &WOutputRenderWindow::beforeRendering, this, [&] {
+            frameStart = clock.nsecsElapsed();
+        });
+        auto endConnection = connect(m_window, &WOutputRenderWindow::renderEnd, this, [&] {
+            const qint64 now = clock.nsecsElapsed();
+            frameTimes.push_back(now);
+            if (frameStart >= 0)
+                frameCosts.push_back((now - frameStart) / 1e6);
+            frameStart = -1;
+        });
+
+        const quint64 start = m_records.first().timestamp;
+        clock.start();
+        for (const Record &record : std::as_const(m_records)) {
+            const qint64 due = record.timestamp - start;
+            while (clock.nsecsElapsed() < due) {
+                const qint64 remaining = (due - clock.nsecsElapsed()) / 1000000;
+                if (remaining > 1)
+                    QTest::qWait(remaining - 1);
+                else
+                    QCoreApplication::processEvents();
+            }
+            dispatch(record);
+        }
+        // Let the last changes reach the screen.
+        QTest::qWait(100);
+        disconnect(startConnection);
+        disconnect(endConnection);
+
+        std::vector<double> intervals;
+        for (size_t i = 1; i < frameTimes.size(); ++i)
+            intervals.push_back((frameTimes[i] - frameTimes[i - 1]) / 1e6);
+
+        if (!recordedIntervals.empty())
+            report("Recorded intervals", recordedIntervals);
+        report("Replayed intervals", intervals);
+        const double p99 = report("Replayed frame cost", frameCosts);
+
+        QVERIFY(!frameCosts.empty());
+
+        bool ok = false;
+        double maxP99 = qEnvironmentVariable("TREELAND_REPLAY_MAX_P99_MS").toDouble(&ok);
+        if (!ok || maxP99 <= 0)
+            maxP99 = 100;
+        QVERIFY2(p99 <= maxP99,
+                 qPrintable(QStringLiteral("p99 frame cost %1 ms exceeds %2 ms")
+                                .arg(p99, 0, 'f', 2)
+                                .arg(maxP99)));
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    // Headless wlroots backend — no display server needed.
+    qputenv("WLR_BACKENDS", "headless");
+
+    WLog::init();
+    WServer::initializeQPA();
+    WRenderHelper::setupRendererBackend();
+
+    QGuiApplication app(argc, argv);
+    QQmlApplicationEngine engine;
+
+    engine.loadFromModule("TestTraceReplay", "TestWindow");
+    if (engine.rootObjects().isEmpty())
+        return 1;
+
+    auto *root = engine.rootObjects().first();
+    auto *window = root->findChild<WOutputRenderWindow *>("renderWindow");
+    Q_ASSERT(window);
+
+    auto *helper = engine.singletonInstance<TestHelper *>("TestTraceReplay", "TestHelper");
+    Q_ASSERT(helper);
+    helper->initProtocols(window, &engine);
+    window->setVisible(true);
+
+    QSignalSpy initSpy(window, &WOutputRenderWindow::outputViewportInitialized);
+    if (initSpy.isEmpty())
+        initSpy.wait(5000);
+    QTest::qWait(500); // let the scene graph settle
+
+    auto *scene = window->findChild<QQuickItem *>("replayScene");
+    Q_ASSERT(scene);
+
+    TraceReplayTest::setGlobals(window, scene);
+
+    TraceReplayTest test;
+    int result = QTest::qExec(&test, argc, argv);
+    // wlroots objects (renderer, allocator, compositor) crash during normal
+    // destructor unwinding — skip cleanup and exit immediately.
+    std::_Exit(result);
+}
+
+#include "main.moc"
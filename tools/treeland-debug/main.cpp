@@ -9,9 +9,11 @@
 #include <QJsonObject>
 #include <QPointF>
 #include <QRemoteObjectNode>
+#include <QSize>
 #include <QTextStream>
 #include <QUrl>
 
+#include "rep_treeland_scene_replica.h"
 #include "rep_treeland_windowtree_replica.h"
 
 namespace {
@@ -107,6 +109,71 @@ QJsonObject treelandInfoToJson(const TreelandInfo &info)
     };
 }
 
+QJsonObject sizeToJson(const QSize &size)
+{
+    return {
+        {"width", size.width()},
+        {"height", size.height()},
+    };
+}
+
+QJsonObject sceneStatsToJson(const SceneStats &stats)
+{
+    return {
+        {"nodes", stats.nodes()},
+        {"geometryNodes", stats.geometryNodes()},
+        {"batches", stats.batches()},
+        {"blitters", stats.blitters()},
+        {"shaderEffectSources", stats.shaderEffectSources()},
+        {"textureBytes", stats.textureBytes()},
+        {"renderTargetBytes", stats.renderTargetBytes()},
+    };
+}
+
+QJsonArray surfacesToJson(const QList<SurfaceSceneInfo> &surfaces)
+{
+    QJsonArray result;
+    for (const auto &surface : surfaces) {
+        result.append(QJsonObject{
+            {"appId", surface.appId()},
+            {"title", surface.title()},
+            {"output", surface.output()},
+            {"type", surface.type()},
+            {"visible", surface.visible()},
+            {"updatedFrames", surface.updatedFrames()},
+            {"stats", sceneStatsToJson(surface.stats())},
+        });
+    }
+    return result;
+}
+
+QJsonArray outputsToJson(const QList<OutputSceneInfo> &outputs)
+{
+    QJsonArray result;
+    for (const auto &output : outputs) {
+        result.append(QJsonObject{
+            {"name", output.name()},
+            {"geometry", rectToJson(output.geometry())},
+            {"pixelSize", sizeToJson(output.pixelSize())},
+            {"scale", output.scale()},
+            {"renderedFrames", output.renderedFrames()},
+            {"stats", sceneStatsToJson(output.stats())},
+            {"surfaces", surfacesToJson(output.surfaces())},
+        });
+    }
+    return result;
+}
+
+QJsonObject sceneInfoToJson(const SceneInfo &info)
+{
+    return {
+        {"frames", info.frames()},
+        {"total", sceneStatsToJson(info.total())},
+        {"outputs", outputsToJson(info.outputs())},
+        {"offscreenSurfaces", surfacesToJson(info.offscreenSurfaces())},
+    };
+}
+
 void registerNamedMetatypes()
 {
     WindowTreeRemoteReplica::registerMetatypes();
@@ -117,6 +184,14 @@ void registerNamedMetatypes()
     qRegisterMetaType<LayerInfo>("LayerInfo");
     qRegisterMetaType<QList<LayerInfo>>("QList<LayerInfo>");
     qRegisterMetaType<TreelandInfo>("TreelandInfo");
+
+    SceneInspectorRemoteReplica::registerMetatypes();
+    qRegisterMetaType<SceneStats>("SceneStats");
+    qRegisterMetaType<SurfaceSceneInfo>("SurfaceSceneInfo");
+    qRegisterMetaType<QList<SurfaceSceneInfo>>("QList<SurfaceSceneInfo>");
+    qRegisterMetaType<OutputSceneInfo>("OutputSceneInfo");
+    qRegisterMetaType<QList<OutputSceneInfo>>("QList<OutputSceneInfo>");
+    qRegisterMetaType<SceneInfo>("SceneInfo");
 }
 
 int fail(const QString &message)
@@ -125,13 +200,30 @@ int fail(const QString &message)
     return EXIT_FAILURE;
 }
 
+int printScene(QRemoteObjectNode &node, const QString &name, int frames, int timeoutMs)
+{
+    auto *replica = node.acquire<SceneInspectorRemoteReplica>(name);
+    if (!replica->waitForSource(timeoutMs))
+        return fail(QStringLiteral("timed out waiting for SceneInspectorRemote source: %1").arg(name));
+
+    auto reply = replica->getSceneInfo(frames);
+    if (!reply.waitForFinished(timeoutMs))
+        return fail("timed out waiting for getSceneInfo()");
+    if (reply.error() != QRemoteObjectPendingCall::NoError)
+        return fail("getSceneInfo() returned a Qt Remote Objects error");
+
+    const QJsonDocument document(sceneInfoToJson(reply.returnValue()));
+    QTextStream(stdout) << QString::fromUtf8(document.toJson(QJsonDocument::Indented));
+    return EXIT_SUCCESS;
+}
+
 } // namespace
 
 int main(int argc, char *argv[])
 {
     QCoreApplication application(argc, argv);
     QCommandLineParser parser;
-    parser.setApplicationDescription("Inspect Treeland debug Remote Objects; currently supports WindowTree.");
+    parser.setApplicationDescription("Inspect Treeland debug Remote Objects; currently supports WindowTree and Scene.");
     parser.addHelpOption();
 
     const QCommandLineOption urlOption(
@@ -140,21 +232,34 @@ int main(int argc, char *argv[])
     const QCommandLineOption timeoutOption("timeout-ms", "Request timeout in milliseconds.", "milliseconds", "30000");
     const QCommandLineOption treeOption("tree", "Print the complete window tree.");
     const QCommandLineOption cursorOption("cursor", "Print the cursor position instead of the window tree.");
+    const QCommandLineOption sceneOption(
+        "scene", "Print scene graph and GPU resource usage per output and window.");
+    const QCommandLineOption sceneNameOption("scene-name", "Scene Remote Object name.", "name", "Scene");
+    const QCommandLineOption framesOption(
+        "frames", "Count window updates over the last N rendered frames.", "count", "60");
     parser.addOption(urlOption);
     parser.addOption(nameOption);
     parser.addOption(timeoutOption);
     parser.addOption(treeOption);
     parser.addOption(cursorOption);
+    parser.addOption(sceneOption);
+    parser.addOption(sceneNameOption);
+    parser.addOption(framesOption);
     parser.process(application);
 
-    if (parser.isSet(treeOption) && parser.isSet(cursorOption))
-        return fail("--tree and --cursor cannot be used together");
+    if (int(parser.isSet(treeOption)) + int(parser.isSet(cursorOption)) + int(parser.isSet(sceneOption)) > 1)
+        return fail("--tree, --cursor and --scene cannot be used together");
 
     bool timeoutValid = false;
     const int timeoutMs = parser.value(timeoutOption).toInt(&timeoutValid);
     if (!timeoutValid || timeoutMs < 0)
         return fail("--timeout-ms must be a non-negative integer");
 
+    bool framesValid = false;
+    const int frames = parser.value(framesOption).toInt(&framesValid);
+    if (!framesValid || frames < 0)
+        return fail("--frames must be a non-negative integer");
+
     registerNamedMetatypes();
 
     const QString url = parser.value(urlOption);
@@ -162,6 +267,9 @@ int main(int argc, char *argv[])
     if (!node.connectToNode(QUrl(url)))
         return fail(QStringLiteral("failed to connect to remote object node: %1").arg(url));
 
+    if (parser.isSet(sceneOption))
+        return printScene(node, parser.value(sceneNameOption), frames, timeoutMs);
+
     const QString name = parser.value(nameOption);
     auto *replica = node.acquire<WindowTreeRemoteReplica>(name);
     if (!replica->waitForSource(timeoutMs))
@@ -8,6 +8,13 @@ WAYLIB_SERVER_BEGIN_NAMESPACE
 
 class WScopedListenerList;
 
+// How long, in ms, a lower output scale has to hold before the scene and the surfaces
+// follow it. A window dragged from a 1.5x to a 1x output leaves and enters the bigger
+// one several times, and an output is disabled and enabled again for a modeset, each
+// scale change makes clients render every buffer and the scene rasterize again.
+// A scale the output itself changes to is applied at once.
+inline constexpr int ScaleDecreaseDelay = 500;
+
 class WAYLIB_SERVER_EXPORT WObjectPrivate
 {
 public:
@@ -14,6 +14,10 @@
 #include <QObject>
 #include <QPointer>
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
 WAYLIB_SERVER_BEGIN_NAMESPACE
 
 class Q_DECL_HIDDEN WSurfacePrivate : public WWaylandResourcePrivate {
@@ -36,7 +40,8 @@ public:
     void setBuffer(wlr_buffer *newBuffer);
     void updateBuffer();
     void updateBufferOffset();
-    void updatePreferredBufferScale();
+    void updateExplicitSync();
+    void updatePreferredBufferScale(bool allowDecrease = false);
     void preferredBufferScaleChange();
 
     WSubsurface *ensureSubsurface(wlr_subsurface *subsurface);
@@ -63,9 +68,15 @@ public:
     bool hasSubsurface = false;
     uint32_t preferredBufferScale = 1;
     uint32_t explicitPreferredBufferScale = 0;
+    // The scale last sent to the client, 0 before the first one.
+    float fractionalScale = 0;
+    QTimer *scaleDecreaseTimer = nullptr;
 
     bool needsFrame = false;
     WBufferUnlockPtr buffer;
+    int acquireFence = -1;
+    wlr_drm_syncobj_timeline *releaseTimeline = nullptr;
+    uint64_t releasePoint = 0;
     QList<WOutput*> outputs;
     WOutput *framePacingOutput = nullptr;
     QMetaObject::Connection frameDoneConnection;
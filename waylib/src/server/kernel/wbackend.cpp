@@ -47,6 +47,9 @@ public:
     QList<WOutput*> outputList;
     QList<WInputDevice*> inputList;
 
+    // Hosts the outputs of createHeadlessOutput, owned by the multi backend.
+    wlr_backend *headless = nullptr;
+
 private:
     wlr_session *session = nullptr;
 };
@@ -131,6 +134,7 @@ void WBackendPrivate::on_destroy()
     q_ptr->removeListeners(q_ptr);
     q->m_handle = nullptr;
     session = nullptr;
+    headless = nullptr;
 }
 
 void WBackendPrivate::connect()
@@ -217,6 +221,30 @@ bool WBackend::isSessionActive() const
     return d->session && d->session->active;
 }
 
+WOutput *WBackend::createHeadlessOutput(const QSize &size)
+{
+    W_D(WBackend);
+    if (!d->headless || size.isEmpty())
+        return nullptr;
+
+    // new_output is emitted synchronously by the started headless backend.
+    auto output = wlr_headless_add_output(d->headless, size.width(), size.height());
+    if (!output)
+        return nullptr;
+
+    for (auto woutput : std::as_const(d->outputList)) {
+        if (woutput->handle() == output)
+            return woutput;
+    }
+
+    return nullptr;
+}
+
+bool WBackend::isHeadlessOutput(const WOutput *output)
+{
+    return output && wlr_output_is_headless(output->handle());
+}
+
 void WBackend::create(WServer *server)
 {
     W_D(WBackend);
@@ -226,6 +254,19 @@ void WBackend::create(WServer *server)
         m_handle = wlr_backend_autocreate(wl_display_get_event_loop(server->handle()), &session);
         Q_ASSERT(m_handle);
         d->session = session;
+
+        // Added before the multi backend starts, so it's started with the others. It has
+        // no output until createHeadlessOutput.
+        if (wlr_backend_is_multi(handle())) {
+            d->headless = wlr_headless_backend_create(wl_display_get_event_loop(server->handle()));
+            if (d->headless && !wlr_multi_backend_add(handle(), d->headless)) {
+                wlr_backend_destroy(d->headless);
+                d->headless = nullptr;
+            }
+        } else if (wlr_backend_is_headless(handle())) {
+            d->headless = handle();
+        }
+
         Q_EMIT created();
     }
 
@@ -249,6 +290,7 @@ void WBackend::destroy([[maybe_unused]] WServer *server)
     auto *backend = reinterpret_cast<wlr_backend*>(m_handle);
     m_handle = nullptr;
     d->session = nullptr;
+    d->headless = nullptr;
     if (backend)
         wlr_backend_destroy(backend);
 }
@@ -7,6 +7,7 @@
 #include <WServer>
 
 #include <QObject>
+#include <QSize>
 
 Q_MOC_INCLUDE("woutput.h")
 Q_MOC_INCLUDE("winputdevice.h")
@@ -37,6 +38,11 @@ public:
 
     bool isSessionActive() const;
 
+    // Adds an output without a display, rendered and committed like the others, e.g. a
+    // remote desktop's screen. Returns nullptr if the backend can't host it.
+    WOutput *createHeadlessOutput(const QSize &size);
+    static bool isHeadlessOutput(const WOutput *output);
+
     QByteArrayView interfaceName() const override;
 
 Q_SIGNALS:
@@ -43,6 +43,7 @@ struct wlr_drm_backend;
 struct wlr_drm_connector;
 struct wlr_drm_format;
 struct wlr_drm_format_set;
+struct wlr_drm_syncobj_timeline;
 struct wlr_export_dmabuf_manager_v1;
 struct wlr_ext_foreign_toplevel_handle_v1;
 struct wlr_ext_foreign_toplevel_handle_v1_state;
@@ -80,6 +81,7 @@ struct wlr_layer_surface_v1_state;
 struct wlr_linux_dmabuf_feedback_v1;
 struct wlr_linux_dmabuf_v1;
 struct wlr_linux_dmabuf_v1_buffer;
+struct wlr_linux_drm_syncobj_manager_v1;
 struct wlr_output;
 struct wlr_output_configuration_v1;
 struct wlr_output_configuration_head_v1;
@@ -153,6 +155,7 @@ struct wlr_tablet_tool_proximity_event;
 struct wlr_tablet_tool_tip_event;
 struct wlr_tablet_v2;
 struct wlr_tablet_v2_tablet;
+struct wlr_tearing_control_manager_v1;
 struct wlr_text_input_manager_v3;
 struct wlr_text_input_v3;
 struct wlr_text_input_v3_state;
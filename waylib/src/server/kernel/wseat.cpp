@@ -17,13 +17,18 @@
 #include <QQuickWindow>
 #include <QGuiApplication>
 #include <QDebug>
+#include <QHash>
 #include <QTimer>
 
 #include <qpa/qwindowsysteminterface.h>
 #include <private/qxkbcommon_p.h>
 #include <private/qquickwindow_p.h>
+#include <private/qguiapplication_p.h>
+#include <private/qshortcutmap_p.h>
 #include <private/qquickdeliveryagent_p_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 Q_GUI_EXPORT bool qt_sendShortcutOverrideEvent(QObject *o, ulong timestamp, int k, Qt::KeyboardModifiers mods, const QString &text = QString(), bool autorep = false, ushort count = 1);
 QT_END_NAMESPACE
@@ -61,6 +66,68 @@ protected:
 };
 #endif
 
+// Keymaps compiled from the same names are shared by the keyboards of all seats. Compiling
+// one takes milliseconds, and wlroots rebuilds a keyboard's xkb state and sends the keymap
+// to the clients again whenever it is set, even if nothing changed. Reusing one xkb_keymap
+// lets setKeyboardKeymap() skip those by comparing pointers.
+class Q_DECL_HIDDEN WXkbKeymapCache
+{
+public:
+    static WXkbKeymapCache *instance() {
+        static WXkbKeymapCache cache;
+        return &cache;
+    }
+
+    // Empty names fall back to the XKB_DEFAULT_* environment and the system defaults.
+    xkb_keymap *keymap(const QString &rules, const QString &model, const QString &layout,
+                       const QString &variant, const QString &options) {
+        const QString key = QStringList{ rules, model, layout, variant, options }.join(QLatin1Char('\n'));
+        if (auto keymap = m_keymaps.value(key))
+            return keymap;
+
+        if (!m_context)
+            m_context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+        if (Q_UNLIKELY(!m_context))
+            return nullptr;
+
+        const QByteArray names[] = { rules.toUtf8(), model.toUtf8(), layout.toUtf8(),
+                                     variant.toUtf8(), options.toUtf8() };
+        auto name = [&names] (int i) {
+            return names[i].isEmpty() ? nullptr : names[i].constData();
+        };
+        const xkb_rule_names ruleNames = { name(0), name(1), name(2), name(3), name(4) };
+        auto keymap = xkb_keymap_new_from_names(m_context, &ruleNames,
+                                                XKB_KEYMAP_COMPILE_NO_FLAGS);
+        if (Q_UNLIKELY(!keymap)) {
+            qCWarning(lcWlSeat) << "Failed to compile keymap, rules:" << rules << "model:" << model
+                                << "layout:" << layout << "variant:" << variant
+                                << "options:" << options;
+            return nullptr;
+        }
+
+        m_keymaps.insert(key, keymap);
+        return keymap;
+    }
+
+private:
+    WXkbKeymapCache() = default;
+    ~WXkbKeymapCache() {
+        for (auto keymap : std::as_const(m_keymaps))
+            xkb_keymap_unref(keymap);
+        if (m_context)
+            xkb_context_unref(m_context);
+    }
+
+    xkb_context *m_context = nullptr;
+    QHash<QString, xkb_keymap*> m_keymaps;
+};
+
+static void setKeyboardKeymap(wlr_keyboard *keyboard, xkb_keymap *keymap)
+{
+    if (keymap && keyboard->keymap != keymap)
+        wlr_keyboard_set_keymap(keyboard, keymap);
+}
+
 class Q_DECL_HIDDEN WSeatPrivate : public WObjectPrivate
 {
 public:
@@ -285,12 +352,18 @@ public:
         qCDebug(lcWlTouch) << "Touch frame for device: " << qwDevice->name()
                                    << ", handle the following state: " << state->m_points;
 
-        if (state->m_points.isEmpty())
+        // Every device gets the frame of any touch device, only send a QTouchEvent
+        // for the ones whose points changed in this frame.
+        const bool changed = std::any_of(state->m_points.cbegin(), state->m_points.cend(),
+                                         [](const QWindowSystemInterface::TouchPoint &tp) {
+                                             return tp.state != QEventPoint::Stationary;
+                                         });
+        if (!changed)
             return;
 
         if (cursor->eventWindow()) {
-            QWindowSystemInterface::handleTouchEvent(cursor->eventWindow(), qwDevice, state->m_points,
-                                                     keyModifiers);
+            QWindowSystemInterface::handleTouchEvent(cursor->eventWindow(), state->m_timestamp,
+                                                     qwDevice, state->m_points, keyModifiers);
         }
 
         for (int i = state->m_points.size() - 1; i >= 0; --i) {
@@ -367,6 +440,7 @@ public:
     void detachInputDevice(WInputDevice *device);
     // handle spontaneous & synthetic key event for focusWindow
     void handleKeyEvent(QKeyEvent &e);
+    bool canNotifyKeyDirectly(int qtkey, bool pressed);
 
     W_DECLARE_PUBLIC(WSeat)
 
@@ -378,6 +452,8 @@ public:
     QPointer<WSeatEventFilter> eventFilter;
     QPointer<QWindow> focusWindow;
     QPointer<QObject> pointerFocusEventObject;
+    // The item that delivered the last key to the keyboard focus surface.
+    QPointer<QObject> keyFocusEventObject;
     QPointer<WSurface> m_keyboardFocusSurface;
     QMetaObject::Connection onEventObjectDestroy;
     wlr_surface *oldPointerFocusSurface = nullptr;
@@ -387,6 +463,12 @@ public:
     qreal lastScale = 1.0;
     wlr_keyboard_group *group = nullptr;
     WInputDevice *groupkeyboardDevice = nullptr;
+    // Owned by WXkbKeymapCache, null for the default keymap.
+    xkb_keymap *keymap = nullptr;
+
+    inline xkb_keymap *currentKeymap() const {
+        return keymap ? keymap : WXkbKeymapCache::instance()->keymap({}, {}, {}, {}, {});
+    }
 
     struct EventState {
         // Don't use it, its may be a invalid pointer
@@ -432,6 +514,8 @@ public:
     struct DeviceState {
         DeviceState() { }
         QList<QWindowSystemInterface::TouchPoint> m_points;
+        // Of the last event in the current frame, Qt derives the point velocities from it.
+        quint64 m_timestamp = 0;
         inline QWindowSystemInterface::TouchPoint *point(int32_t touch_id) {
             for (int i = 0; i < m_points.size(); ++i)
                 if (m_points.at(i).id == touch_id)
@@ -567,6 +651,30 @@ void WSeatPrivate::handleKeyEvent(QKeyEvent &e)
     QCoreApplication::sendEvent(focusWindow, &e);
 }
 
+// Building a QKeyEvent and sending it through the QQuickWindow only ends in
+// doNotifyKey when the item of the focus surface has the active focus, and no
+// filter or shortcut wants the key. Skip all that for such keys.
+bool WSeatPrivate::canNotifyKeyDirectly(int qtkey, bool pressed)
+{
+    W_Q(WSeat);
+
+    auto window = qobject_cast<QQuickWindow*>(focusWindow.get());
+    if (!window || !keyboardFocusSurface() || !keyFocusEventObject
+        || window->activeFocusItem() != keyFocusEventObject) {
+        return false;
+    }
+
+#if QT_CONFIG(shortcut)
+    auto &shortcutMap = QGuiApplicationPrivate::instance()->shortcutMap;
+    if (shortcutMap.state() != QKeySequence::NoMatch
+        || shortcutMap.hasShortcutForKeySequence(QKeySequence(QKeyCombination(keyModifiers, Qt::Key(qtkey))))) {
+        return false;
+    }
+#endif
+
+    return !eventFilter || !eventFilter->wantsKeyEvent(q, qtkey, keyModifiers, pressed);
+}
+
 void WSeatPrivate::on_keyboard_key(wlr_keyboard_key_event *event, WInputDevice *device)
 {
     auto keyboard = wlr_keyboard_from_input_device(device->handle());
@@ -593,6 +701,16 @@ void WSeatPrivate::on_keyboard_key(wlr_keyboard_key_event *event, WInputDevice *
     }
 
     int qtkey = QXkbCommon::keysymToQtKey(sym, keyModifiers, keyboard->xkb_state, code);
+    if (canNotifyKeyDirectly(qtkey, et == QEvent::KeyPress)) {
+        // The client repeats its keys, stop repeating the last key of the compositor.
+        if (m_repeatKey && (et == QEvent::KeyPress || m_repeatKey->nativeScanCode() == code)) {
+            m_repeatTimer.stop();
+            m_repeatKey.reset();
+        }
+        doNotifyKey(device, event->keycode, event->state, event->time_msec);
+        return;
+    }
+
     const QString &text = QXkbCommon::lookupString(keyboard->xkb_state, code);
 
     QKeyEvent e(et, qtkey, keyModifiers, code, event->keycode, wlr_keyboard_get_modifiers(keyboard),
@@ -673,15 +791,8 @@ void WSeatPrivate::attachInputDevice(WInputDevice *device)
         auto keyboard = wlr_keyboard_from_input_device(device->handle());
 
         if (device == groupkeyboardDevice || device->isVirtual()) {
-            /* We need to prepare an XKB keymap and assign it to the keyboard.
-             * This assumes the defaults (e.g. layout = "us"). */
-            struct xkb_rule_names rules = {};
-            struct xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-            struct xkb_keymap *keymap = xkb_map_new_from_names(context, &rules,
-                                                               XKB_KEYMAP_COMPILE_NO_FLAGS);
-            wlr_keyboard_set_keymap(keyboard, keymap);
-            xkb_keymap_unref(keymap);
-            xkb_context_unref(context);
+            // Virtual keyboards start with the seat's keymap until their client sends one.
+            setKeyboardKeymap(keyboard, currentKeymap());
 
             auto *listeners = device->listeners(q_ptr);
             listeners->add(&keyboard->events.key, this,
@@ -697,18 +808,12 @@ void WSeatPrivate::attachInputDevice(WInputDevice *device)
             // Reuse group keymap pointer so wlr_seat_set_keyboard() sees
             // no keymap change and skips a spurious keymap event.
             if (group && group->keyboard.keymap) {
-                wlr_keyboard_set_keymap(keyboard, group->keyboard.keymap);
+                setKeyboardKeymap(keyboard, group->keyboard.keymap);
             } else {
                 qCWarning(lcWlSeat,
                           "WSeat: group keyboard has no keymap for physical keyboard '%s'",
                           qPrintable(device->name()));
-                struct xkb_rule_names rules = {};
-                struct xkb_context *context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-                struct xkb_keymap *keymap = xkb_map_new_from_names(context, &rules,
-                                                                   XKB_KEYMAP_COMPILE_NO_FLAGS);
-                wlr_keyboard_set_keymap(keyboard, keymap);
-                xkb_keymap_unref(keymap);
-                xkb_context_unref(context);
+                setKeyboardKeymap(keyboard, currentKeymap());
             }
             wlr_keyboard_group_add_keyboard(group, keyboard);
         }
@@ -1004,6 +1109,8 @@ bool WSeat::sendEvent(WSurface *target, QObject *shellObject, QObject *eventObje
     }
     case QEvent::KeyPress: {
         auto e = static_cast<QKeyEvent*>(event);
+        if (target && target->handle() == d->keyboardFocusSurface())
+            d->keyFocusEventObject = eventObject;
         if (!e->isAutoRepeat())
             d->doNotifyKey(inputDevice, e->nativeVirtualKey(), WL_KEYBOARD_KEY_STATE_PRESSED, e->timestamp());
         break;
@@ -1170,6 +1277,31 @@ WInputDevice *WSeat::keyboardGroupKeyboard() const
     return d->groupkeyboardDevice;
 }
 
+bool WSeat::setKeymap(const QString &layout, const QString &variant, const QString &options,
+                      const QString &model, const QString &rules)
+{
+    W_D(WSeat);
+
+    auto keymap = WXkbKeymapCache::instance()->keymap(rules, model, layout, variant, options);
+    if (!keymap)
+        return false;
+
+    d->keymap = keymap;
+    if (!d->group || d->group->keyboard.keymap == keymap)
+        return true;
+
+    // The group passes a member's new keymap on to the other members and takes it last,
+    // so the clients get the keymap once instead of once per keyboard.
+    for (auto device : std::as_const(d->deviceList)) {
+        if (device->type() != WInputDevice::Type::Keyboard || device->isVirtual())
+            continue;
+        setKeyboardKeymap(wlr_keyboard_from_input_device(device->handle()), keymap);
+    }
+    setKeyboardKeymap(&d->group->keyboard, keymap);
+
+    return true;
+}
+
 WInputDevice *WSeat::keyboard() const
 {
     W_DC(WSeat);
@@ -1408,7 +1540,7 @@ void WSeat::notifyHoldEnd(WCursor *cursor, WInputDevice *device, uint32_t time_m
 
 // deal with touch event form wlr_cursor
 
-void WSeat::notifyTouchDown(WCursor *cursor, WInputDevice *device, int32_t touch_id, [[maybe_unused]] uint32_t time_msec)
+void WSeat::notifyTouchDown(WCursor *cursor, WInputDevice *device, int32_t touch_id, uint32_t time_msec)
 {
     auto qwDevice = qobject_cast<QPointingDevice*>(device->qtDevice());
     Q_ASSERT(qwDevice);
@@ -1440,12 +1572,13 @@ void WSeat::notifyTouchDown(WCursor *cursor, WInputDevice *device, int32_t touch
     newTp.area = QRect(0, 0, 8, 8);
     newTp.area.moveCenter(globalPos);
     state->m_points.append(newTp);
+    state->m_timestamp = time_msec;
     qCDebug(lcWlTouch) << "Touch down form device: " << qwDevice->name()
                                << ", touch id: " << touch_id
                                << ", at position" << globalPos;
 }
 
-void WSeat::notifyTouchMotion(WCursor *cursor, WInputDevice *device, int32_t touch_id, [[maybe_unused]] uint32_t time_msec)
+void WSeat::notifyTouchMotion(WCursor *cursor, WInputDevice *device, int32_t touch_id, uint32_t time_msec)
 {
     auto qwDevice = qobject_cast<QPointingDevice*>(device->qtDevice());
     Q_ASSERT(qwDevice);
@@ -1464,6 +1597,7 @@ void WSeat::notifyTouchMotion(WCursor *cursor, WInputDevice *device, int32_t tou
         // Handle this by compressing and keeping the Pressed state until the 'frame'.
         if (tp->state != QEventPoint::Pressed && tp->state != QEventPoint::Released)
             tp->state = tmpState;
+        state->m_timestamp = time_msec;
         qCDebug(lcWlTouch) << "Touch move form device: " << qwDevice->name()
                                    << ", touch id: " << touch_id
                                    << ", to position: " << globalPos
@@ -1473,7 +1607,7 @@ void WSeat::notifyTouchMotion(WCursor *cursor, WInputDevice *device, int32_t tou
     }
 }
 
-void WSeat::notifyTouchUp(WCursor *cursor, WInputDevice *device, int32_t touch_id, [[maybe_unused]] uint32_t time_msec)
+void WSeat::notifyTouchUp(WCursor *cursor, WInputDevice *device, int32_t touch_id, uint32_t time_msec)
 {
     auto qwDevice = qobject_cast<QPointingDevice*>(device->qtDevice());
     Q_ASSERT(qwDevice);
@@ -1483,6 +1617,7 @@ void WSeat::notifyTouchUp(WCursor *cursor, WInputDevice *device, int32_t touch_i
 
     if (Q_LIKELY(tp)) {
         tp->state = QEventPoint::Released;
+        state->m_timestamp = time_msec;
         // There may not be a Frame event after the last Up. Work this around.
         // IF All Points has Released, Send a Frame event immediately
         // Ref: https://github.com/qt/qtbase/blob/6.5/src/platformsupport/input/libinput/qlibinputtouch.cpp#L150
@@ -1801,6 +1936,11 @@ bool WSeatEventFilter::unacceptedEvent(WSeat *, QWindow *, QInputEvent *)
     return false;
 }
 
+bool WSeatEventFilter::wantsKeyEvent(WSeat *, int, Qt::KeyboardModifiers, bool)
+{
+    return true;
+}
+
 QList<WInputDevice*> WSeat::deviceList() const
 {
     W_DC(WSeat);
@@ -43,6 +43,9 @@ protected:
                                        QObject *eventObject, QInputEvent *event);
     virtual bool beforeDisposeEvent(WSeat *seat, QWindow *watched, QInputEvent *event);
     virtual bool unacceptedEvent(WSeat *seat, QWindow *watched, QInputEvent *event);
+    // Asked before a key is translated to a QKeyEvent, return false to let it go straight
+    // to the keyboard focus surface without passing this filter and the QWindow.
+    virtual bool wantsKeyEvent(WSeat *seat, int key, Qt::KeyboardModifiers modifiers, bool pressed);
 };
 
 class WCursor;
@@ -95,6 +98,11 @@ public:
     void clearKeyboardFocusWindow();
 
     WInputDevice *keyboardGroupKeyboard() const;
+    // Applies the keymap compiled from the RMLVO names to all keyboards of the seat, the
+    // compiled keymaps are shared between seats. Empty names use the xkbcommon defaults.
+    bool setKeymap(const QString &layout, const QString &variant = {},
+                   const QString &options = {}, const QString &model = {},
+                   const QString &rules = {});
     WInputDevice *keyboard() const;
     void setKeyboard(WInputDevice *newKeyboard);
 
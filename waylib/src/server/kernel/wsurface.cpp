@@ -5,6 +5,7 @@
 #include "wscoplistener.h"
 #include "wseat.h"
 #include "private/wsurface_p.h"
+#include "private/wglobal_p.h"
 #include "woutput.h"
 #include "wsubsurface.h"
 #include "wayliblogging.h"
@@ -12,9 +13,93 @@
 #include <wlr_all.h>
 
 #include <QDebug>
+#include <QTimer>
+
+#include <cerrno>
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
 WAYLIB_SERVER_BEGIN_NAMESPACE
 
+static int dmabufIoctl(int fd, unsigned long request, void *arg)
+{
+    int ret;
+    do {
+        ret = ioctl(fd, request, arg);
+    } while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+    return ret;
+}
+
+// Attach the client's acquire fence to the dma-buf as an implicit write fence,
+// so every reader (the renderer, KMS on direct scanout) waits for it on the GPU.
+static bool importBufferFence(wlr_buffer *buffer, int syncFileFd)
+{
+#ifdef DMA_BUF_IOCTL_IMPORT_SYNC_FILE
+    wlr_dmabuf_attributes attribs;
+    if (!wlr_buffer_get_dmabuf(buffer, &attribs))
+        return false;
+
+    for (int i = 0; i < attribs.n_planes; ++i) {
+        dma_buf_import_sync_file data = {};
+        data.flags = DMA_BUF_SYNC_WRITE;
+        data.fd = syncFileFd;
+        if (dmabufIoctl(attribs.fd[i], DMA_BUF_IOCTL_IMPORT_SYNC_FILE, &data) != 0)
+            return false;
+    }
+    return true;
+#else
+    Q_UNUSED(buffer);
+    Q_UNUSED(syncFileFd);
+    return false;
+#endif
+}
+
+// The fence of the last frame the renderer submitted, see WSurface::setFrameFence().
+static int s_frameFence = -1;
+
+// Signals a release point once the buffer is released. The renderer only reads a
+// released buffer in frames it already submitted, so the point takes the fence of
+// the last frame and the client waits for our GPU reads instead of us.
+struct Q_DECL_HIDDEN ReleasePoint
+{
+    ReleasePoint(wlr_buffer *buffer, wlr_drm_syncobj_timeline *timeline, uint64_t point)
+        : buffer(buffer)
+        , timeline(wlr_drm_syncobj_timeline_ref(timeline))
+        , point(point)
+    {
+        release.notify = [](wl_listener *listener, void *) {
+            ReleasePoint *self = wl_container_of(listener, self, release);
+            self->signal(s_frameFence >= 0 ? dup(s_frameFence) : -1);
+        };
+        wl_signal_add(&buffer->events.release, &release);
+        destroy.notify = [](wl_listener *listener, void *) {
+            ReleasePoint *self = wl_container_of(listener, self, destroy);
+            self->signal(-1);
+        };
+        wl_signal_add(&buffer->events.destroy, &destroy);
+    }
+
+    void signal(int syncFileFd)
+    {
+        if (syncFileFd < 0 || !wlr_drm_syncobj_timeline_import_sync_file(timeline, point, syncFileFd))
+            wlr_drm_syncobj_timeline_signal(timeline, point);
+        if (syncFileFd >= 0)
+            close(syncFileFd);
+
+        wl_list_remove(&release.link);
+        wl_list_remove(&destroy.link);
+        wlr_drm_syncobj_timeline_unref(timeline);
+        delete this;
+    }
+
+    wl_listener release;
+    wl_listener destroy;
+    wlr_buffer *buffer;
+    wlr_drm_syncobj_timeline *timeline;
+    uint64_t point;
+};
+
 WSurfacePrivate::WSurfacePrivate(WSurface *qq, wlr_surface *handle)
     : WWaylandResourcePrivate(qq)
 {
@@ -25,7 +110,10 @@ WSurfacePrivate::WSurfacePrivate(WSurface *qq, wlr_surface *handle)
 
 WSurfacePrivate::~WSurfacePrivate()
 {
-
+    if (acquireFence >= 0)
+        close(acquireFence);
+    if (releaseTimeline)
+        wlr_drm_syncobj_timeline_unref(releaseTimeline);
 }
 
 wl_client *WSurfacePrivate::waylandClient() const
@@ -41,8 +129,10 @@ void WSurfacePrivate::on_commit()
 
     needsFrame = !wl_list_empty(&m_handle->current.frame_callback_list);
 
-    if (m_handle->current.committed & WLR_SURFACE_STATE_BUFFER)
+    if (m_handle->current.committed & WLR_SURFACE_STATE_BUFFER) {
         updateBuffer();
+        updateExplicitSync();
+    }
 
     if (m_handle->current.committed & WLR_SURFACE_STATE_OFFSET)
         updateBufferOffset();
@@ -127,6 +217,43 @@ void WSurfacePrivate::updateBuffer()
     setBuffer(buffer);
 }
 
+void WSurfacePrivate::updateExplicitSync()
+{
+    if (acquireFence >= 0) {
+        close(acquireFence);
+        acquireFence = -1;
+    }
+
+    auto *state = wlr_linux_drm_syncobj_v1_get_surface_state(m_handle);
+    if (!state || !state->acquire_timeline || !buffer)
+        return;
+
+    // wlroots only held the commit until the acquire point materialized, the
+    // client may still be rendering into the buffer.
+    acquireFence = wlr_drm_syncobj_timeline_export_sync_file(state->acquire_timeline,
+                                                             state->acquire_point);
+    if (acquireFence < 0) {
+        qCWarning(lcWlSurface) << "Failed to export the acquire fence of" << q_func();
+    } else if (!importBufferFence(buffer.get(), acquireFence)) {
+        qCDebug(lcWlSurface) << "Can't attach the acquire fence to the buffer of" << q_func()
+                             << ", only the renderer will wait for it";
+    }
+
+    if (!releaseTimeline)
+        releaseTimeline = wlr_drm_syncobj_timeline_create(state->acquire_timeline->drm_fd);
+
+    auto *loop = wl_display_get_event_loop(wl_client_get_display(waylandClient()));
+    if (!releaseTimeline
+        || !wlr_linux_drm_syncobj_v1_state_add_release_point(state, releaseTimeline,
+                                                             ++releasePoint, loop)) {
+        // Let wlroots signal the client's release point on the CPU instead.
+        wlr_linux_drm_syncobj_v1_state_signal_release_with_buffer(state, buffer.get());
+        return;
+    }
+
+    new ReleasePoint(buffer.get(), releaseTimeline, releasePoint);
+}
+
 void WSurfacePrivate::updateBufferOffset()
 {
     W_Q(WSurface);
@@ -137,18 +264,44 @@ void WSurfacePrivate::updateBufferOffset()
     }
 }
 
-void WSurfacePrivate::updatePreferredBufferScale()
+void WSurfacePrivate::updatePreferredBufferScale(bool allowDecrease)
 {
     if (explicitPreferredBufferScale > 0)
         return;
+    // A hidden or minimized surface keeps its scale, the client has nothing to render again for.
+    if (outputs.isEmpty() && fractionalScale > 0)
+        return;
 
     float maxScale = 1.0;
     for (auto o : std::as_const(outputs))
         maxScale = std::max(o->scale(), maxScale);
+
+    // The client renders every buffer again for a new scale, only go down once it settles.
+    if (!allowDecrease && maxScale < fractionalScale) {
+        if (!scaleDecreaseTimer) {
+            W_Q(WSurface);
+            scaleDecreaseTimer = new QTimer(q);
+            scaleDecreaseTimer->setSingleShot(true);
+            scaleDecreaseTimer->setInterval(ScaleDecreaseDelay);
+            QObject::connect(scaleDecreaseTimer, &QTimer::timeout, q, [this] {
+                updatePreferredBufferScale(true);
+            });
+        }
+        if (!scaleDecreaseTimer->isActive())
+            scaleDecreaseTimer->start();
+        return;
+    }
+
+    if (scaleDecreaseTimer)
+        scaleDecreaseTimer->stop();
+    fractionalScale = maxScale;
     if (handle())
         wlr_fractional_scale_v1_notify_scale(m_handle, maxScale);
 
-    preferredBufferScale = qCeil(maxScale);
+    const uint32_t scale = qCeil(maxScale);
+    if (preferredBufferScale == scale)
+        return;
+    preferredBufferScale = scale;
     preferredBufferScaleChange();
 }
 
@@ -439,6 +592,19 @@ wlr_buffer *WSurface::buffer() const
     return d->buffer.get();
 }
 
+int WSurface::acquireFence() const
+{
+    W_DC(WSurface);
+    return d->acquireFence >= 0 ? dup(d->acquireFence) : -1;
+}
+
+void WSurface::setFrameFence(int syncFileFd)
+{
+    if (s_frameFence >= 0)
+        close(s_frameFence);
+    s_frameFence = syncFileFd;
+}
+
 void WSurface::notifyFrameDone()
 {
     W_D(WSurface);
@@ -449,6 +615,19 @@ void WSurface::notifyFrameDone()
     wlr_surface_send_frame_done(d->handle(), &now);
 }
 
+void WSurface::notifyTexturedOnOutput(WOutput *output)
+{
+    W_D(WSurface);
+    // No-op if the client didn't ask for feedback or it's already queued in this frame.
+    wlr_presentation_surface_textured_on_output(d->handle(), output->handle());
+}
+
+void WSurface::notifyScannedOutOnOutput(WOutput *output)
+{
+    W_D(WSurface);
+    wlr_presentation_surface_scanned_out_on_output(d->handle(), output->handle());
+}
+
 void WSurface::enterOutput(WOutput *output)
 {
     W_D(WSurface);
@@ -460,7 +639,7 @@ void WSurface::enterOutput(WOutput *output)
         leaveOutput(output);
     });
     QObject::connect(output, &WOutput::scaleChanged, this, [d] {
-        d->updatePreferredBufferScale();
+        d->updatePreferredBufferScale(true);
     });
 
     d->updateOutputs();
@@ -49,8 +49,18 @@ public:
     int bufferScale() const;
     QPoint bufferOffset() const;
     wlr_buffer *buffer() const;
+    // A sync_file of the client's acquire point for the current buffer when the
+    // surface uses wp_linux_drm_syncobj_v1, or -1. Every call returns a new fd owned
+    // by the caller, so each consumer of the buffer can wait for it.
+    int acquireFence() const;
+    // The renderer hands over the fence of each frame it submits, takes the fd. Buffers
+    // released afterwards signal their release point with it, or at once when it's -1.
+    static void setFrameFence(int syncFileFd);
 
     void notifyFrameDone();
+    // Queue wp_presentation feedback for the current buffer on the next commit of output
+    void notifyTexturedOnOutput(WOutput *output);
+    void notifyScannedOutOnOutput(WOutput *output);
 
     bool isSubsurface() const;
     bool hasSubsurface() const;
@@ -329,6 +329,18 @@ QTransform WBufferRenderer::inputMapToOutput(const QRectF &sourceRect, const QRe
     return t;
 }
 
+QRegion WBufferRenderer::mapDamage(const QRegion &region, const QTransform &transform, const QRect &bounds)
+{
+    if (transform.isIdentity())
+        return region & bounds;
+
+    QRegion result;
+    for (const QRect &rect : region)
+        result += transform.mapRect(QRectF(rect)).toAlignedRect();
+
+    return result & bounds;
+}
+
 wlr_buffer *WBufferRenderer::beginRender(const QSize &pixelSize, qreal devicePixelRatio,
                                         uint32_t format, RenderFlags flags,
                                         WGlobal::ColorContentsMode mode)
@@ -406,8 +418,10 @@ wlr_buffer *WBufferRenderer::beginRender(const QSize &pixelSize, qreal devicePix
         sgRT.paintDevice = rtd->u.paintDevice;
 
         if (devicePixelRatio != 1.0) {
-            state.dirty = QTransform::fromScale(1.0 / devicePixelRatio,
-                                                1.0 / devicePixelRatio).map(state.dirty);
+            const QRect logicalRect = QRectF(QPointF(0, 0), QSizeF(pixelSize) / devicePixelRatio).toAlignedRect();
+            state.dirty = mapDamage(state.dirty,
+                                    QTransform::fromScale(1.0 / devicePixelRatio, 1.0 / devicePixelRatio),
+                                    logicalRect);
         }
     } else {
         state.dirty = QRegion();
@@ -446,7 +460,8 @@ inline static QRect scaleToRect(const QRectF &s, qreal scale) {
 }
 
 void WBufferRenderer::render(int sourceIndex, const QMatrix4x4 &renderMatrix,
-                             const QRectF &sourceRect, const QRectF &targetRect)
+                             const QRectF &sourceRect, const QRectF &targetRect,
+                             const QRegion *sceneDamage)
 {
     Q_ASSERT(state.buffer);
 
@@ -588,8 +603,25 @@ void WBufferRenderer::render(int sourceIndex, const QMatrix4x4 &renderMatrix,
 
     { // after render
         if (!softwareRenderer) {
-            // TODO: get damage area from QRhi renderer
-            wlr_damage_ring_add_whole(m_damageRing.get());
+            // The QRhi renderer always redraws the whole buffer, the damage only tells
+            // wlroots (and the planes, the capture clients) which part of it changed.
+            const QTransform sceneToBuffer = state.worldTransform.toTransform()
+                                             * inputMapToOutput(sourceRect, targetRect,
+                                                                state.pixelSize, devicePixelRatio)
+                                             * QTransform::fromScale(devicePixelRatio, devicePixelRatio);
+            if (sceneDamage && isRootItem(source.source)
+                && sceneToBuffer == m_sceneToBuffer && state.pixelSize == m_sceneDamagePixelSize) {
+                WPixmanRegion damage;
+                const QRegion bufferDamage = mapDamage(*sceneDamage, sceneToBuffer,
+                                                       QRect(QPoint(0, 0), state.pixelSize));
+                bool ok = WTools::toPixmanRegion(bufferDamage, damage);
+                Q_ASSERT(ok);
+                wlr_damage_ring_add(m_damageRing.get(), damage);
+            } else {
+                wlr_damage_ring_add_whole(m_damageRing.get());
+            }
+            m_sceneToBuffer = sceneToBuffer;
+            m_sceneDamagePixelSize = state.pixelSize;
             // ###: maybe Qt bug? Before executing QRhi::endOffscreenFrame, we may
             // use the same QSGRenderer for multiple drawings. This can lead to
             // rendering the same content for different QSGRhiRenderTarget instances
@@ -607,7 +639,8 @@ void WBufferRenderer::render(int sourceIndex, const QMatrix4x4 &renderMatrix,
             Q_ASSERT(currentImage && currentImage == softwareRenderer->renderTarget().paintDevice);
             currentImage->setDevicePixelRatio(1.0);
             const auto scaleTF = QTransform::fromScale(devicePixelRatio, devicePixelRatio);
-            const auto scaledFlushRegion = scaleTF.map(softwareRenderer->flushRegion());
+            const auto scaledFlushRegion = mapDamage(softwareRenderer->flushRegion(), scaleTF,
+                                                     QRect(QPoint(0, 0), state.pixelSize));
             WPixmanRegion scaledFlushDamage;
             bool ok = WTools::toPixmanRegion(scaledFlushRegion, scaledFlushDamage);
             Q_ASSERT(ok);
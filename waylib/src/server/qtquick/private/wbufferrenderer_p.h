@@ -82,6 +82,8 @@ public:
 
     static QTransform inputMapToOutput(const QRectF &sourceRect, const QRectF &targetRect,
                                        const QSize &pixelSize, const qreal devicePixelRatio);
+    // Rounds outwards, so pixels only partially covered by a scaled or rotated rect are kept.
+    static QRegion mapDamage(const QRegion &region, const QTransform &transform, const QRect &bounds);
 
 Q_SIGNALS:
     void sceneGraphChanged();
@@ -94,8 +96,10 @@ protected:
     wlr_buffer *beginRender(const QSize &pixelSize, qreal devicePixelRatio,
                             uint32_t format, RenderFlags flags = {},
                             WGlobal::ColorContentsMode mode = WGlobal::ColorContentsMode::DontCare);
+    // sceneDamage is what changed in the scene since this renderer rendered last, nullptr if unknown.
     void render(int sourceIndex, const QMatrix4x4 &renderMatrix,
-                const QRectF &sourceRect = {}, const QRectF &targetRect = {});
+                const QRectF &sourceRect = {}, const QRectF &targetRect = {},
+                const QRegion *sceneDamage = nullptr);
     void endRender();
     void componentComplete() override;
 
@@ -152,6 +156,9 @@ private:
 
     QList<Data> m_sourceList;
     WDamageRing m_damageRing;
+    // The scene to buffer mapping of the last frame, scene damage only applies while unchanged.
+    QTransform m_sceneToBuffer;
+    QSize m_sceneDamagePixelSize;
     mutable std::unique_ptr<WSGTextureProvider> m_textureProvider;
     QColor m_clearColor = Qt::transparent;
     QList<QObject*> m_cacheBufferLocker;
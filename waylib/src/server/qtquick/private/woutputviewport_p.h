@@ -27,6 +27,7 @@ public:
         , ignoreViewport(false)
         , disableHardwareLayers(false)
         , ignoreSoftwareLayers(false)
+        , allowTearing(false)
     {
 
     }
@@ -46,6 +47,15 @@ public:
         return (forceRender || live) && q_func()->isVisible();
     }
 
+    // False only if the viewport surely shows nothing of the scene's damage, i.e. it
+    // renders the window's contentItem under its own rect without extra sources.
+    inline bool showsSceneDamage(const QRegion &sceneDamage) const {
+        W_QC(WOutputViewport);
+        if (input || extraRenderSource || viewportTransform || ignoreViewport || !depends.isEmpty())
+            return true;
+        return sceneDamage.intersects(q->mapRectToScene(q->effectiveSourceRect()).toAlignedRect());
+    }
+
     void init();
     void initForOutput();
     void update();
@@ -88,6 +98,7 @@ public:
     uint ignoreViewport:1;
     uint disableHardwareLayers:1;
     uint ignoreSoftwareLayers:1;
+    uint allowTearing:1;
 };
 
 WAYLIB_SERVER_END_NAMESPACE
@@ -21,6 +21,8 @@
 #endif
 #include <private/qquickwindow_p.h>
 
+#include <optional>
+
 WAYLIB_SERVER_BEGIN_NAMESPACE
 
 class Q_DECL_HIDDEN WOutputHelperPrivate : public WObjectPrivate
@@ -90,6 +92,20 @@ public:
 
     // External state (mode/scale/transform/enabled) separate from internal (buffer/damage)
     WOutputHelper::ExtraState extraState;
+
+    // Whether the backend takes a tearing page flip only changes with the mode and the
+    // format of the buffer, so the test isn't done again for every tearing commit.
+    struct TearingTestKey {
+        QSize modeSize;
+        int refresh = 0;
+        uint32_t format = 0;
+        uint64_t modifier = 0;
+
+        bool operator==(const TearingTestKey &other) const = default;
+    };
+    bool testTearingPageFlip(const wlr_output_state *state);
+    std::optional<TearingTestKey> tearingTestKey;
+    bool tearingTestResult = false;
 };
 
 void WOutputHelperPrivate::setContentIsDirty(bool newValue)
@@ -100,6 +116,30 @@ void WOutputHelperPrivate::setContentIsDirty(bool newValue)
     Q_EMIT q_func()->contentIsDirtyChanged();
 }
 
+bool WOutputHelperPrivate::testTearingPageFlip(const wlr_output_state *state)
+{
+    // A commit changing more than the buffer is tested as a whole.
+    const uint32_t bufferOnly = WLR_OUTPUT_STATE_BUFFER | WLR_OUTPUT_STATE_DAMAGE
+        | WLR_OUTPUT_STATE_WAIT_TIMELINE | WLR_OUTPUT_STATE_SIGNAL_TIMELINE;
+    if (!state->buffer || (state->committed & ~bufferOnly))
+        return wlr_output_test_state(qwoutput(), state);
+
+    TearingTestKey key;
+    key.modeSize = QSize(qwoutput()->width, qwoutput()->height);
+    key.refresh = qwoutput()->refresh;
+    wlr_dmabuf_attributes attribs;
+    if (wlr_buffer_get_dmabuf(state->buffer, &attribs)) {
+        key.format = attribs.format;
+        key.modifier = attribs.modifier;
+    }
+
+    if (tearingTestKey != key) {
+        tearingTestKey = key;
+        tearingTestResult = wlr_output_test_state(qwoutput(), state);
+    }
+    return tearingTestResult;
+}
+
 wlr_buffer *WOutputHelperPrivate::acquireBuffer(wlr_swapchain **sc)
 {
     bool ok = wlr_output_configure_primary_swapchain(qwoutput(), &state, sc);
@@ -199,6 +239,12 @@ const pixman_region32 *WOutputHelper::damage() const
     return &d->state.damage;
 }
 
+void WOutputHelper::setTearingPageFlip(bool tearing)
+{
+    W_D(WOutputHelper);
+    d->state.tearing_page_flip = tearing;
+}
+
 void WOutputHelper::setLayers(const wlr_output_layer_state_array &layers)
 {
     W_D(WOutputHelper);
@@ -234,9 +280,16 @@ bool WOutputHelper::commit()
         wlr_output_state_copy(&state, d->extraState.get());
     }
 
+    if (state.tearing_page_flip && !d->testTearingPageFlip(&state)) {
+        qCDebug(lcWlOutputHelper, "tearing page flip rejected on output %s, using vsync", d->qwoutput()->name);
+        state.tearing_page_flip = false;
+    }
+
     bool ok = wlr_output_commit_state(d->qwoutput(), &state);
     if (!ok) {
         qCCritical(lcWlOutputHelper, "commit failed on output %s", d->qwoutput()->name);
+        // Don't trust a cached tearing test once a commit failed.
+        d->tearingTestKey.reset();
     }
     wlr_output_state_finish(&state);
     ExtraState committedExtraState = d->extraState;
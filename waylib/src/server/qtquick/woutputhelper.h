@@ -53,6 +53,8 @@ public:
     void setDamage(const pixman_region32 *damage);
     const pixman_region32 *damage() const;
     void setLayers(const wlr_output_layer_state_array &layers);
+    // Request an async page flip, falls back to vsync if the backend refuses it
+    void setTearingPageFlip(bool tearing);
     bool commit();
     bool testCommit();
     bool testCommit(wlr_buffer *buffer, const wlr_output_layer_state_array &layers);
@@ -37,6 +37,9 @@ public:
         DontClip = 1 << 1,
         NoAlpha = 1 << 3,
         Cursor = 1 << 4,
+        // For a SurfaceItemContent, offer the client's dmabuf to the plane without
+        // rendering it when the item maps 1:1 onto the output.
+        DirectScanout = 1 << 5,
     };
     Q_ENUM(Flag)
     Q_DECLARE_FLAGS(Flags, Flag)
@@ -12,6 +12,9 @@
 #include "woutputviewport_p.h"
 #include "wqmlhelper_p.h"
 #include "woutputlayer.h"
+#include "wsurfaceitem.h"
+#include "wsurface.h"
+#include "wquickcursor.h"
 #include "wbufferrenderer_p.h"
 #include "wquicktextureproxy.h"
 #include "wpointer.h"
@@ -20,6 +23,7 @@
 #include "winputdevice.h"
 #include "wseat.h"
 #include "wayliblogging.h"
+#include "private/wglobal_p.h"
 
 #include "platformplugin/qwlrootsintegration.h"
 #include "platformplugin/qwlrootscreen.h"
@@ -33,8 +37,10 @@
 #include <QQuickRenderControl>
 #include <QOpenGLFunctions>
 #include <QRunnable>
+#include <QTimer>
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <private/qsgrenderer_p.h>
@@ -146,6 +152,8 @@ public:
         // dirty state
         uint contentsIsDirty:1;
         // end
+        // the client buffer is given to the plane instead of renderer's buffer
+        bool directScanout = false;
 
         QRectF mapRect;
         QRectF noClipMapRect;
@@ -217,6 +225,20 @@ public:
 
     void updateSceneDPR();
 
+    // What changed in the scene since this output rendered last, unset when it's more than
+    // surface contents. An output skipping frames collects their damage until it renders.
+    std::optional<QRegion> sceneDamage;
+    inline void addSceneDamage(const std::optional<QRegion> &damage) {
+        if (!damage) {
+            sceneDamage.reset();
+        } else if (sceneDamage) {
+            *sceneDamage += *damage;
+            // Don't let an output that doesn't render for long collect countless rects.
+            if (sceneDamage->rectCount() > 32)
+                *sceneDamage = sceneDamage->boundingRect();
+        }
+    }
+
     int indexOfLayer(OutputLayer *layer) const;
     LayerData *getLayer(OutputLayer *layer) const;
     bool attachLayer(OutputLayer *layer);
@@ -237,11 +259,15 @@ public:
         return on;
     }
 
+    bool updateLayerGeometry(LayerData *layer, qreal *devicePixelRatio);
     wlr_buffer *renderLayer(LayerData *layer, bool *dontEndRenderAndReturnNeedsEndRender);
+    wlr_buffer *directScanoutBuffer(LayerData *layer);
+    wlr_buffer *directCursorBuffer(LayerData *layer);
+    wlr_buffer *copyToCursorBuffer(wlr_buffer *source, const QSize &pixelSize);
     WBufferRenderer *afterRender();
     WBufferRenderer *compositeLayers(const QList<LayerData*> layers, bool forceShadowRenderer);
     bool commit(WBufferRenderer *buffer);
-    bool tryToHardwareCursor(const LayerData *layer);
+    bool tryToHardwareCursor(const LayerData *layer, wlr_buffer *layerBuffer = nullptr);
 
 private:
     WOutputViewport *m_output = nullptr;
@@ -252,6 +278,11 @@ private:
     BufferRendererProxy *m_cursorLayerProxy = nullptr;
     bool m_cursorDirty = false;
     bool m_hardwareCursorRenderComplete = false;
+    // only for the cursor buffer given by WQuickCursor
+    quint64 m_directCursorSerial = 0;
+    WUniquePointer<wlr_swapchain> m_cursorSwapchain;
+    WBufferUnlockPtr m_cursorCopy;
+    quint64 m_cursorCopySerial = 0;
 
     // for compositeLayers
     QPointer<WOutputViewport> m_output2;
@@ -270,9 +301,52 @@ public:
         return m_outputs;
     }
     inline void beforeRender(WOutputRenderWindow *window) {
-        setEnabled(!window->disableLayers() || layer->force());
+        bool enable = !window->disableLayers() || layer->force();
+        if (enable && layer->flags().testFlag(WOutputLayer::DirectScanout)) {
+            // Only hold the item out of the scene while its client buffer can go to a
+            // plane as-is, otherwise let the GPU composite it like any other item.
+            auto buffer = scanoutCandidate();
+            enable = buffer != nullptr;
+            if (enable && enabled && !layer->isAccepted()
+                && rejectedScanout != ScanoutKey::of(buffer)) {
+                // The buffer changed since the backend rejected it, offer it again.
+                reset();
+            }
+        }
+        setEnabled(enable);
         state = Normal;
     }
+    inline wlr_buffer *scanoutCandidate() const {
+        if (layer->force() || layer->keepLayer() || layer->flags().testFlag(WOutputLayer::Cursor))
+            return nullptr;
+        auto content = qobject_cast<WSurfaceItemContent*>(layer->parent());
+        if (!content || !content->surface() || content->opacity() < 1.0)
+            return nullptr;
+        auto buffer = content->surface()->buffer();
+        auto handle = content->surface()->handle();
+        if (!buffer || handle->current.transform != WL_OUTPUT_TRANSFORM_NORMAL
+            || handle->current.viewport.has_src || m_outputs.isEmpty())
+            return nullptr;
+        // Only a buffer every output shows untouched is a candidate: the output's transform
+        // and scale, and exactly as many pixels as the item covers there.
+        const QSizeF sceneSize = content->mapRectToScene(content->boundingRect()).size();
+        for (auto viewport : m_outputs) {
+            auto output = viewport->output();
+            const qreal scale = viewport->devicePixelRatio();
+            if (!output || output->handle()->transform != WL_OUTPUT_TRANSFORM_NORMAL)
+                return nullptr;
+            // A viewport destination (fractional scaling) sizes the surface instead of the
+            // buffer scale, the size check covers it.
+            if (!handle->current.viewport.has_dst && handle->current.scale != scale)
+                return nullptr;
+            if ((sceneSize * scale).toSize() != QSize(buffer->width, buffer->height))
+                return nullptr;
+        }
+        wlr_dmabuf_attributes attribs;
+        if (!wlr_buffer_get_dmabuf(buffer, &attribs))
+            return nullptr;
+        return buffer;
+    }
     inline void setEnabled(bool enable) {
         if (enabled == enable)
             return;
@@ -351,6 +425,28 @@ private:
 
     State state;
 
+    // What decides if a plane can take a client buffer. The buffers of a client's swapchain
+    // share it, so the rejection of one isn't tested again for each of the others.
+    struct ScanoutKey {
+        QSize size;
+        uint32_t format = DRM_FORMAT_INVALID;
+        uint64_t modifier = DRM_FORMAT_MOD_INVALID;
+
+        static ScanoutKey of(wlr_buffer *buffer) {
+            ScanoutKey key;
+            key.size = QSize(buffer->width, buffer->height);
+            wlr_dmabuf_attributes attribs;
+            if (wlr_buffer_get_dmabuf(buffer, &attribs)) {
+                key.format = attribs.format;
+                key.modifier = attribs.modifier;
+            }
+            return key;
+        }
+        bool operator==(const ScanoutKey &other) const = default;
+    };
+    // the last client buffer the backend refused to scan out
+    ScanoutKey rejectedScanout;
+
     QList<WOutputViewport*> m_outputs;
 };
 
@@ -373,6 +469,11 @@ public:
         : QQuickWindowPrivate()
         , listenerOwner(std::make_unique<WListenerOwner>())
     {
+        sceneDPRDecreaseTimer.setSingleShot(true);
+        sceneDPRDecreaseTimer.setInterval(ScaleDecreaseDelay);
+        QObject::connect(&sceneDPRDecreaseTimer, &QTimer::timeout, [this] {
+            updateSceneDPR(true);
+        });
     }
     ~WOutputRenderWindowPrivate() {
         qDeleteAll(layers);
@@ -427,7 +528,8 @@ public:
     void init();
     void init(OutputHelper *helper);
     bool initRCWithRhi();
-    void updateSceneDPR();
+    void updateSceneDPR(bool allowDecrease = false);
+    void applySceneDPR(qreal dpr);
     void sortOutputs();
 
     QVector<std::pair<OutputHelper *, WBufferRenderer *>>
@@ -440,6 +542,19 @@ public:
         rendererList.push(renderer);
     }
 
+    bool collectSceneDamage(QRegion *damage);
+    void exportFrameFence();
+    // Hides QQuickWindowPrivate::updateDirtyNodes, the items synced in the middle of a
+    // frame aren't part of the scene damage and the outputs rendered before missed them.
+    inline void updateDirtyNodes() {
+        if (dirtyItemList) {
+            for (auto o : std::as_const(outputs))
+                o->sceneDamage.reset();
+            fullDamageNextFrame = true;
+        }
+        QQuickWindowPrivate::updateDirtyNodes();
+    }
+
     inline void scheduleDoRender() {
         if (!isInitialized())
             return; // Not initialized
@@ -472,6 +587,15 @@ public:
 
     QStack<WBufferRenderer*> rendererList;
 
+    bool fullDamageNextFrame = false;
+    QHash<const QQuickItem*, QRectF> contentSceneRects;
+
+    // The scene's DPR, 0 before the first output. Every text, layer and offscreen item is
+    // rasterized again when it changes, so it goes down only after outputs stay away a
+    // moment, e.g. undocking or an output that is disabled and enabled for a modeset.
+    qreal sceneDPR = 0;
+    QTimer sceneDPRDecreaseTimer;
+
     // Owner token for per-output frame/needs_frame listeners registered on
     // WOutput via WObject::listeners(). ~WListenerOwner/teardown() detaches
     // them; reset early from ~WOutputRenderWindow.
@@ -485,7 +609,8 @@ WOutputRenderWindowPrivate *OutputHelper::renderWindowD() const
 
 void OutputHelper::updateSceneDPR()
 {
-    WOutputRenderWindowPrivate::get(renderWindow())->updateSceneDPR();
+    // The output's own scale changed, no window is moving across outputs.
+    WOutputRenderWindowPrivate::get(renderWindow())->updateSceneDPR(true);
 }
 
 int OutputHelper::indexOfLayer(OutputLayer *layer) const
@@ -583,6 +708,10 @@ void OutputHelper::cleanCursorRender()
         m_cursorRenderer = nullptr;
         m_cursorLayerProxy = nullptr;
     }
+
+    m_cursorCopy.reset();
+    m_cursorSwapchain.reset();
+    m_cursorCopySerial = 0;
 }
 
 wlr_buffer *OutputHelper::beginRender(WBufferRenderer *renderer,
@@ -596,8 +725,10 @@ wlr_buffer *OutputHelper::beginRender(WBufferRenderer *renderer,
 void OutputHelper::render(WBufferRenderer *renderer, int sourceIndex, const QMatrix4x4 &renderMatrix,
                           const QRectF &sourceRect, const QRectF &targetRect)
 {
-    renderWindowD()->pushRenderer(renderer);
-    renderer->render(sourceIndex, renderMatrix, sourceRect, targetRect);
+    auto wd = renderWindowD();
+    wd->pushRenderer(renderer);
+    renderer->render(sourceIndex, renderMatrix, sourceRect, targetRect,
+                     sceneDamage ? &*sceneDamage : nullptr);
 }
 
 static QQuickItem *createVisualRectangle(QQuickItem *target, const QColor &color) {
@@ -616,35 +747,9 @@ static inline QRectF scaleRect(const QRectF &r, qreal xScale, qreal yScale) {
     return QRectF(r.x() * xScale, r.y() * yScale, r.width() * xScale, r.height() * yScale);
 }
 
-wlr_buffer *OutputHelper::renderLayer(LayerData *layer, bool *dontEndRenderAndReturnNeedsEndRender)
+bool OutputHelper::updateLayerGeometry(LayerData *layer, qreal *devicePixelRatioOut)
 {
     auto source = layer->layer->layer->parent();
-    if (!source->parentItem() || source->window() != renderWindow())
-        return nullptr;
-
-    if (!layer->renderer) {
-        layer->renderer = new WBufferRenderer(source);
-        if (visualizeLayers())
-            layer->renderer->setClearColor(Qt::yellow);
-
-        QList<QQuickItem*> sourceList {source};
-        if (visualizeLayers()) {
-            auto rectangle = createVisualRectangle(source, Qt::green);
-            QQuickItemPrivate::get(rectangle)->refFromEffectItem(true);
-            sourceList << rectangle;
-        }
-
-        layer->renderer->setSourceList(sourceList, false);
-        layer->renderer->setOutput(outputViewport()->output());
-
-        // for the new WBufferRenderer and createVisualRectangle
-        renderWindowD()->updateDirtyNodes();
-
-        layer->rendererConnection = connect(layer->renderer, &WBufferRenderer::sceneGraphChanged, this, [layer] {
-            layer->contentsIsDirty = true;
-        });
-    }
-
     qreal dpr = devicePixelRatio();
 
     {
@@ -714,7 +819,7 @@ wlr_buffer *OutputHelper::renderLayer(LayerData *layer, bool *dontEndRenderAndRe
         }
 
         if (mapRect.isEmpty()) {
-            return nullptr;
+            return false;
         }
         Q_ASSERT(!pixelSize.isEmpty());
 
@@ -744,7 +849,45 @@ wlr_buffer *OutputHelper::renderLayer(LayerData *layer, bool *dontEndRenderAndRe
         }
     }
 
+
     layer->mapToOutput = QRect((layer->mapRect.topLeft() * dpr).toPoint(), layer->pixelSize);
+    *devicePixelRatioOut = dpr;
+    return true;
+}
+
+wlr_buffer *OutputHelper::renderLayer(LayerData *layer, bool *dontEndRenderAndReturnNeedsEndRender)
+{
+    auto source = layer->layer->layer->parent();
+    if (!source->parentItem() || source->window() != renderWindow())
+        return nullptr;
+
+    if (!layer->renderer) {
+        layer->renderer = new WBufferRenderer(source);
+        if (visualizeLayers())
+            layer->renderer->setClearColor(Qt::yellow);
+
+        QList<QQuickItem*> sourceList {source};
+        if (visualizeLayers()) {
+            auto rectangle = createVisualRectangle(source, Qt::green);
+            QQuickItemPrivate::get(rectangle)->refFromEffectItem(true);
+            sourceList << rectangle;
+        }
+
+        layer->renderer->setSourceList(sourceList, false);
+        layer->renderer->setOutput(outputViewport()->output());
+
+        // for the new WBufferRenderer and createVisualRectangle
+        renderWindowD()->updateDirtyNodes();
+
+        layer->rendererConnection = connect(layer->renderer, &WBufferRenderer::sceneGraphChanged, this, [layer] {
+            layer->contentsIsDirty = true;
+        });
+    }
+
+    qreal dpr = devicePixelRatio();
+    if (!updateLayerGeometry(layer, &dpr))
+        return nullptr;
+
     auto buffer = layer->renderer->lastBuffer();
 
     if (!buffer || layer->contentsIsDirty) {
@@ -789,6 +932,132 @@ wlr_buffer *OutputHelper::renderLayer(LayerData *layer, bool *dontEndRenderAndRe
     return buffer;
 }
 
+wlr_buffer *OutputHelper::directScanoutBuffer(LayerData *layer)
+{
+    layer->directScanout = false;
+
+    // A layer that can't be rejected may need software composite, which
+    // requires the content rendered by WBufferRenderer.
+    if (!layer->layer->tryReject()
+        || outputViewport()->disableHardwareLayers()
+        || output()->transform != WL_OUTPUT_TRANSFORM_NORMAL)
+        return nullptr;
+
+    auto buffer = layer->layer->scanoutCandidate();
+    if (!buffer)
+        return nullptr;
+
+    qreal dpr = devicePixelRatio();
+    if (!updateLayerGeometry(layer, &dpr))
+        return nullptr;
+
+    // The plane shows the client buffer untouched, so the item must map
+    // onto output pixels 1:1, without clipping, scaling or rotation.
+    if (layer->pixelSize != QSize(buffer->width, buffer->height)
+        || layer->mapRect != layer->noClipMapRect
+        || layer->renderMatrix.toTransform().type() > QTransform::TxTranslate)
+        return nullptr;
+
+    layer->directScanout = true;
+    // The renderer's buffer doesn't follow the client while scanning out directly.
+    layer->contentsIsDirty = true;
+
+    return buffer;
+}
+
+// The cursor's own pixels, a xcursor image or a client's cursor buffer, go to the cursor
+// plane without rendering the cursor layer with Qt Quick.
+wlr_buffer *OutputHelper::directCursorBuffer(LayerData *layer)
+{
+    layer->directScanout = false;
+
+    if (!layer->layer->layer->flags().testFlag(WOutputLayer::Cursor)
+        || !layer->layer->tryReject()
+        || outputViewport()->disableHardwareLayers()
+        || output()->transform != WL_OUTPUT_TRANSFORM_NORMAL)
+        return nullptr;
+
+    auto cursor = qobject_cast<WQuickCursor*>(layer->layer->layer->parent());
+    if (!cursor)
+        return nullptr;
+
+    quint64 serial = 0;
+    auto buffer = cursor->contentBuffer(&serial);
+    if (!buffer)
+        return nullptr;
+
+    qreal dpr = devicePixelRatio();
+    if (!updateLayerGeometry(layer, &dpr))
+        return nullptr;
+
+    // Same as directScanoutBuffer, the buffer must map onto output pixels 1:1. A cursor
+    // clipped by the output's edge goes through the Qt Quick path.
+    if (layer->pixelSize != QSize(buffer->width, buffer->height)
+        || layer->mapRect != layer->noClipMapRect
+        || layer->renderMatrix.toTransform().type() > QTransform::TxTranslate)
+        return nullptr;
+
+    layer->directScanout = true;
+    layer->contentsIsDirty = true;
+    m_directCursorSerial = serial;
+
+    return buffer;
+}
+
+// Copies the cursor into a buffer of the cursor plane's formats with the wlroots
+// renderer, for the buffers the plane can't take as they are (shm, other sizes).
+wlr_buffer *OutputHelper::copyToCursorBuffer(wlr_buffer *source, const QSize &pixelSize)
+{
+    if (m_cursorCopy && m_cursorCopySerial == m_directCursorSerial
+        && QSize(m_cursorCopy->width, m_cursorCopy->height) == pixelSize)
+        return m_cursorCopy.get();
+
+    wlr_swapchain *sc = m_cursorSwapchain.release();
+    bool ok = outputViewport()->output()->configureCursorSwapchain(pixelSize, DRM_FORMAT_ARGB8888, &sc);
+    m_cursorSwapchain.reset(sc);
+    if (!ok)
+        return nullptr;
+
+    auto renderer = renderWindow()->renderer();
+    wlr_texture *texture = nullptr;
+    WUniquePointer<wlr_texture> ownedTexture;
+    if (auto clientBuffer = wlr_client_buffer_get(source)) {
+        texture = clientBuffer->texture;
+    } else {
+        ownedTexture.reset(wlr_texture_from_buffer(renderer, source));
+        texture = ownedTexture.get();
+    }
+    if (!texture)
+        return nullptr;
+
+    WBufferUnlockPtr target(wlr_swapchain_acquire(m_cursorSwapchain.get()));
+    if (!target)
+        return nullptr;
+
+    auto pass = wlr_renderer_begin_buffer_pass(renderer, target.get(), nullptr);
+    if (!pass)
+        return nullptr;
+
+    wlr_render_rect_options clear = {};
+    clear.box = { 0, 0, pixelSize.width(), pixelSize.height() };
+    clear.color = { 0, 0, 0, 0 };
+    clear.blend_mode = WLR_RENDER_BLEND_MODE_NONE;
+    wlr_render_pass_add_rect(pass, &clear);
+
+    wlr_render_texture_options options = {};
+    options.texture = texture;
+    options.dst_box = { 0, 0, source->width, source->height };
+    options.blend_mode = WLR_RENDER_BLEND_MODE_PREMULTIPLIED;
+    wlr_render_pass_add_texture(pass, &options);
+    if (!wlr_render_pass_submit(pass))
+        return nullptr;
+
+    m_cursorCopy = std::move(target);
+    m_cursorCopySerial = m_directCursorSerial;
+
+    return m_cursorCopy.get();
+}
+
 struct Q_DECL_HIDDEN QScopedPointerWlArrayDeleter {
     static inline void cleanup(wl_array *pointer) {
         if (pointer)
@@ -821,7 +1090,11 @@ WBufferRenderer *OutputHelper::afterRender()
             continue;
 
         bool needsEndBuffer = false;
-        auto buffer = renderLayer(i, &needsEndBuffer);
+        auto buffer = directScanoutBuffer(i);
+        if (!buffer)
+            buffer = directCursorBuffer(i);
+        if (!buffer)
+            buffer = renderLayer(i, &needsEndBuffer);
         if (!buffer)
             continue;
 
@@ -835,7 +1108,8 @@ WBufferRenderer *OutputHelper::afterRender()
                 .width = i->mapToOutput.width(),
                 .height = i->mapToOutput.height(),
             },
-            .damage = &i->renderer->damageRing()->current,
+            // the client's buffer damage isn't tracked per plane, damage it entirely
+            .damage = i->directScanout ? nullptr : &i->renderer->damageRing()->current,
             .accepted = false
         });
 
@@ -844,7 +1118,7 @@ WBufferRenderer *OutputHelper::afterRender()
             i->renderer->endRender();
         }
 
-        Q_ASSERT(!i->renderer->currentBuffer());
+        Q_ASSERT(i->directScanout || !i->renderer->currentBuffer());
         needsCompositeLayers.append(i);
 
         if (firstCantRejectLayerIndex == m_layers.size() && !i->layer->tryReject())
@@ -878,8 +1152,9 @@ WBufferRenderer *OutputHelper::afterRender()
         if ((!outputViewport()->disableHardwareLayers() || topLayer->layer->forceLayer())
             && !(ok && layers.last().accepted)
             && (topLayer->layer->layer->flags() & WOutputLayer::Cursor)) {
-            if (tryToHardwareCursor(topLayer)) {
-                Q_ASSERT(topLayer->renderer->lastBuffer() == layers.last().buffer);
+            if (tryToHardwareCursor(topLayer, layers.last().buffer)) {
+                Q_ASSERT(topLayer->directScanout
+                         || topLayer->renderer->lastBuffer() == layers.last().buffer);
                 Q_ASSERT(!hasHardwareCursor);
                 hasHardwareCursor = true;
                 bool ok = topLayer->layer->accept(outputViewport(), true);
@@ -894,7 +1169,8 @@ WBufferRenderer *OutputHelper::afterRender()
     for (int i = layers.length() - 1; i >= 0; --i) {
         const auto &state = layers.at(i);
         Q_ASSERT(state.buffer);
-        OutputLayer *layer = needsCompositeLayers[i]->layer;
+        LayerData *layerData = needsCompositeLayers[i];
+        OutputLayer *layer = layerData->layer;
 
         // If hardware layers is disabled on this output viewport
         // and this layer doesn't want force layer, should fallback
@@ -909,6 +1185,12 @@ WBufferRenderer *OutputHelper::afterRender()
             if (ok && state.accepted) {
                 bool ok = layer->accept(outputViewport(), true);
                 Q_ASSERT(ok);
+                // Claim the feedback before the item reports it as textured.
+                auto content = layerData->directScanout
+                                   ? qobject_cast<WSurfaceItemContent*>(layer->layer->parent())
+                                   : nullptr;
+                if (content)
+                    content->surface()->notifyScannedOutOnOutput(outputViewport()->output());
                 continue;
             } else {
                 needsSoftwareCompositeEndIndex = i;
@@ -924,14 +1206,21 @@ WBufferRenderer *OutputHelper::afterRender()
             Q_ASSERT(ok);
             if (layer->forceLayer())
                 forceShadowRender = true;
+            if (layerData->directScanout) {
+                // Software composite needs the rendered content of this layer
+                layerData->directScanout = false;
+                renderLayer(layerData, nullptr);
+            }
             needsSoftwareCompositeBeginIndex = i;
         } else if (!outputViewport()->ignoreSoftwareLayers()) {
             bool ok = layer->reject(outputViewport());
             Q_ASSERT(ok);
+            if (layerData->directScanout)
+                layer->rejectedScanout = OutputLayer::ScanoutKey::of(state.buffer);
         }
     }
 
-    if (!hasHardwareCursor && m_cursorRenderer) {
+    if (!hasHardwareCursor && (m_cursorRenderer || m_hardwareCursorRenderComplete)) {
         // Clear hardware cursor
         tryToHardwareCursor(nullptr);
         // Don't cleanCursorRender(), maybe will use in next frame
@@ -1027,6 +1316,11 @@ WBufferRenderer *OutputHelper::compositeLayers(const QList<LayerData*> layers, b
         }
 
         LayerData *layer = layers.at(i);
+        if (layer->directScanout) {
+            // A plane candidate the backend rejected, it has no rendered content yet.
+            layer->directScanout = false;
+            renderLayer(layer, nullptr);
+        }
         proxy->setRenderer(layer->renderer);
         proxy->setPosition(layer->mapRect.topLeft());
         proxy->setSize(layer->mapRect.size());
@@ -1089,17 +1383,20 @@ bool OutputHelper::commit(WBufferRenderer *buffer)
     }
 
     m_lastCommitBuffer = buffer;
+    setTearingPageFlip(outputViewport()->allowTearing());
 
     return WOutputHelper::commit();
 }
 
-bool OutputHelper::tryToHardwareCursor(const LayerData *layer)
+bool OutputHelper::tryToHardwareCursor(const LayerData *layer, wlr_buffer *layerBuffer)
 {
     do {
         auto set_cursor = output()->impl->set_cursor;
-        auto buffer = layer && layer->renderer->lastBuffer()
-                          ? layer->renderer->lastBuffer()
-                          : nullptr;
+        wlr_buffer *buffer = nullptr;
+        if (layer && layer->directScanout)
+            buffer = layerBuffer;
+        else if (layer && layer->renderer->lastBuffer())
+            buffer = layer->renderer->lastBuffer();
         if (!buffer) {
             if (!m_hardwareCursorRenderComplete)
                 return true;
@@ -1173,7 +1470,19 @@ bool OutputHelper::tryToHardwareCursor(const LayerData *layer)
             }
         }
 
-        if (needsRepaintCursor) {
+        if (layer->directScanout) {
+            // A client's dmabuf in a supported size goes to the plane as it is.
+            wlr_dmabuf_attributes attribs;
+            const bool isDmabuf = wlr_buffer_get_dmabuf(buffer, &attribs);
+            if (isDmabuf && get_cursor_formsts && !needsRepaintCursor) {
+                auto formats = get_cursor_formsts(output(), renderWindow()->allocator()->buffer_caps);
+                needsRepaintCursor = !formats || !wlr_drm_format_set_has(formats, attribs.format, attribs.modifier);
+            }
+            if (!isDmabuf || needsRepaintCursor)
+                buffer = copyToCursorBuffer(buffer, pixelSize);
+            if (!buffer)
+                break;
+        } else if (needsRepaintCursor) {
             // needs render cursor again
             if (!m_cursorRenderer) {
                 m_cursorRenderer = new WBufferRenderer(renderWindow()->contentItem());
@@ -1418,9 +1727,8 @@ bool WOutputRenderWindowPrivate::initRCWithRhi()
     return true;
 }
 
-void WOutputRenderWindowPrivate::updateSceneDPR()
+void WOutputRenderWindowPrivate::updateSceneDPR(bool allowDecrease)
 {
-    W_Q(WOutputRenderWindow);
     if (outputs.isEmpty()
         // Maybe the platform window is destroyed
         || !platformWindow) {
@@ -1434,8 +1742,25 @@ void WOutputRenderWindowPrivate::updateSceneDPR()
             maxDPR = o->outputViewport()->output()->scale();
     }
 
-    setSceneDevicePixelRatio(maxDPR);
-    Q_EMIT q->effectiveDevicePixelRatioChanged(maxDPR);
+    if (!allowDecrease && sceneDPR > 0 && maxDPR < sceneDPR) {
+        if (!sceneDPRDecreaseTimer.isActive())
+            sceneDPRDecreaseTimer.start();
+        return;
+    }
+
+    sceneDPRDecreaseTimer.stop();
+    applySceneDPR(maxDPR);
+}
+
+void WOutputRenderWindowPrivate::applySceneDPR(qreal dpr)
+{
+    W_Q(WOutputRenderWindow);
+    if (qFuzzyCompare(sceneDPR, dpr))
+        return;
+
+    sceneDPR = dpr;
+    setSceneDevicePixelRatio(dpr);
+    Q_EMIT q->effectiveDevicePixelRatioChanged(dpr);
 }
 
 void WOutputRenderWindowPrivate::sortOutputs()
@@ -1483,6 +1808,14 @@ WOutputRenderWindowPrivate::doRenderOutputs(wlr_output *needsFrameOutput, const
                 renderResults.append(helper);
                 continue;
             }
+
+            // Nobody looks at a headless output but its capture clients, leave it alone
+            // until the scene changes inside it.
+            if (!captureLocked && helper->sceneDamage && !helper->extraState()
+                && wlr_output_is_headless(helper->output())
+                && !WOutputViewportPrivate::get(helper->outputViewport())->showsSceneDamage(*helper->sceneDamage)) {
+                continue;
+            }
         }
 
         Q_ASSERT(helper->outputViewport()->output()->scale() <= helper->outputViewport()->devicePixelRatio());
@@ -1502,6 +1835,8 @@ WOutputRenderWindowPrivate::doRenderOutputs(wlr_output *needsFrameOutput, const
             helper->render(helper->bufferRenderer(), 0, renderMatrix,
                            helper->outputViewport()->effectiveSourceRect(),
                            helper->outputViewport()->targetRect());
+            // The buffer holds everything up to this frame now.
+            helper->sceneDamage = QRegion();
         }
         renderResults.append(helper);
     }
@@ -1537,6 +1872,91 @@ static void QQuickAnimatorController_advance(QQuickAnimatorController *ac)
         W_PRIVATE_MEMBER(*ac, QQuickAnimCtrl_m_window_tag{})->update();
 }
 
+// The scene damage can only be derived from the dirty items when nothing but surface
+// contents changed, the rest (moves, opacity, effects) falls back to damaging everything.
+bool WOutputRenderWindowPrivate::collectSceneDamage(QRegion *damage)
+{
+    // Animators change the scene graph nodes without dirtying their items.
+    bool ok = W_PRIVATE_MEMBER(*animationController, QQuickAnimCtrl_m_runningAnimators_tag{}).isEmpty();
+
+    for (QQuickItem *item = dirtyItemList; item; item = QQuickItemPrivate::get(item)->nextDirtyItem) {
+        auto content = qobject_cast<WSurfaceItemContent*>(item);
+        if (!content) {
+            ok = false;
+            continue;
+        }
+
+        if (QQuickItemPrivate::get(item)->dirtyAttributes & ~QQuickItemPrivate::Content)
+            ok = false;
+
+        // The content may be sampled by a layer, a ShaderEffectSource or a texture proxy.
+        for (auto i = item; i && ok; i = i->parentItem()) {
+            auto d = QQuickItemPrivate::get(i);
+            if (d->extra.isAllocated() && d->extra->effectRefCount > 0)
+                ok = false;
+        }
+
+        const QPointF offset = content->ignoreBufferOffset() ? QPointF() : QPointF(content->bufferOffset());
+        const QRectF rect = content->mapRectToScene(QRectF(offset, content->size()));
+        auto it = contentSceneRects.find(content);
+        if (it == contentSceneRects.end()) {
+            // Unknown where the previous frame drew it.
+            ok = false;
+            contentSceneRects.insert(content, rect);
+            QObject::connect(content, &QObject::destroyed, q_func(), [this, content] {
+                contentSceneRects.remove(content);
+            });
+            continue;
+        }
+
+        *damage += it->united(rect).toAlignedRect();
+        *it = rect;
+    }
+
+    return ok;
+}
+
+// Hands the fence of the frame just submitted to WSurface, the release points of the
+// wp_linux_drm_syncobj_v1 buffers released until the next frame wait for it.
+void WOutputRenderWindowPrivate::exportFrameFence()
+{
+    if (!m_renderer || !m_renderer->features.timeline)
+        return;
+
+    int fd = -1;
+#ifdef ENABLE_VULKAN_RENDER
+    if (wlr_renderer_is_vk(m_renderer)) {
+        // Qt submits on wlroots' queue, a fence after its frame covers the reads.
+        fd = waylib_vk_renderer_export_sync_file(m_renderer);
+    } else
+#endif
+    if (glContext && wlr_renderer_is_gles2(m_renderer)) {
+#ifndef QT_NO_OPENGL
+        static auto eglCreateSyncKHR =
+            reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"));
+        static auto eglDestroySyncKHR =
+            reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"));
+        static auto eglDupNativeFenceFDANDROID =
+            reinterpret_cast<PFNEGLDUPNATIVEFENCEFDANDROIDPROC>(eglGetProcAddress("eglDupNativeFenceFDANDROID"));
+        if (eglCreateSyncKHR && eglDestroySyncKHR && eglDupNativeFenceFDANDROID) {
+            auto display = eglGetCurrentDisplay();
+            const EGLint attribs[] = { EGL_NONE };
+            auto sync = eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID, attribs);
+            if (sync != EGL_NO_SYNC_KHR) {
+                // The fence only gets its fd once it's flushed.
+                glFlush();
+                fd = eglDupNativeFenceFDANDROID(display, sync);
+                eglDestroySyncKHR(display, sync);
+            }
+        }
+#endif
+    }
+
+    if (fd < 0)
+        qCWarning(lcWlRenderer, "Failed to create the fence of the frame");
+    WSurface::setFrameFence(fd);
+}
+
 void WOutputRenderWindowPrivate::doRender(wlr_output *needsFrameOutput,
                                           const QList<OutputHelper *> &outputs,
                                           bool forceRender, bool doCommit)
@@ -1555,6 +1975,16 @@ void WOutputRenderWindowPrivate::doRender(wlr_output *needsFrameOutput,
 
     rc()->polishItems();
 
+    // What changed in the scene in this frame, unset when it's more than surface contents.
+    // Also given to the outputs not rendering in this frame, they use it once they render.
+    QRegion damage;
+    std::optional<QRegion> sceneDamage;
+    if (collectSceneDamage(&damage) && !forceRender && !fullDamageNextFrame)
+        sceneDamage = damage;
+    fullDamageNextFrame = false;
+    for (auto helper : std::as_const(this->outputs))
+        helper->addSceneDamage(sceneDamage);
+
     if (QSGRendererInterface::isApiRhiBased(WRenderHelper::getGraphicsApi()))
         rc()->beginFrame();
     rc()->sync();
@@ -1570,6 +2000,7 @@ void WOutputRenderWindowPrivate::doRender(wlr_output *needsFrameOutput,
 
     if (QSGRendererInterface::isApiRhiBased(WRenderHelper::getGraphicsApi()))
         rc()->endFrame();
+    exportFrameFence();
 
     // prevent gles2-render exception in wlroots.
     // wlroots may have render operations after commit, so do
@@ -362,6 +362,22 @@ void WOutputViewport::setIgnoreSoftwareLayers(bool newIgnoreSoftwareLayers)
     Q_EMIT ignoreSoftwareLayersChanged();
 }
 
+bool WOutputViewport::allowTearing() const
+{
+    W_DC(WOutputViewport);
+    return d->allowTearing;
+}
+
+void WOutputViewport::setAllowTearing(bool newAllowTearing)
+{
+    W_D(WOutputViewport);
+    if (d->allowTearing == newAllowTearing)
+        return;
+    // Only affects how the next frame is committed, no repaint needed.
+    d->allowTearing = newAllowTearing;
+    Q_EMIT allowTearingChanged();
+}
+
 QRectF WOutputViewport::targetRect() const
 {
     W_DC(WOutputViewport);
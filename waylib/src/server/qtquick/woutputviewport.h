@@ -31,6 +31,7 @@ class WAYLIB_SERVER_EXPORT WOutputViewport : public QQuickItem, public virtual W
     Q_PROPERTY(bool ignoreViewport READ ignoreViewport WRITE setIgnoreViewport NOTIFY ignoreViewportChanged FINAL)
     Q_PROPERTY(bool disableHardwareLayers READ disableHardwareLayers WRITE setDisableHardwareLayers NOTIFY disableHardwareLayersChanged FINAL)
     Q_PROPERTY(bool ignoreSoftwareLayers READ ignoreSoftwareLayers WRITE setIgnoreSoftwareLayers NOTIFY ignoreSoftwareLayersChanged FINAL)
+    Q_PROPERTY(bool allowTearing READ allowTearing WRITE setAllowTearing NOTIFY allowTearingChanged FINAL)
     Q_PROPERTY(QList<WAYLIB_SERVER_NAMESPACE::WOutputLayer*> layers READ layers NOTIFY layersChanged FINAL)
     Q_PROPERTY(QList<WAYLIB_SERVER_NAMESPACE::WOutputLayer*> hardwareLayers READ hardwareLayers NOTIFY hardwareLayersChanged FINAL)
     Q_PROPERTY(QList<WAYLIB_SERVER_NAMESPACE::WOutputViewport*> depends READ depends WRITE setDepends NOTIFY dependsChanged FINAL)
@@ -96,6 +97,9 @@ public:
     bool ignoreSoftwareLayers() const;
     void setIgnoreSoftwareLayers(bool newIgnoreSoftwareLayers);
 
+    bool allowTearing() const;
+    void setAllowTearing(bool newAllowTearing);
+
     QList<WOutputLayer*> layers() const;
     QList<WOutputLayer*> hardwareLayers() const;
 
@@ -122,6 +126,7 @@ Q_SIGNALS:
     void ignoreViewportChanged();
     void disableHardwareLayersChanged();
     void ignoreSoftwareLayersChanged();
+    void allowTearingChanged();
     void layersChanged();
     void hardwareLayersChanged();
     void dependsChanged();
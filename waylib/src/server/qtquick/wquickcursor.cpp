@@ -157,7 +157,13 @@ public:
     QString xcursorThemeName;
     QSize cursorSize = QSize(24, 24);
     QPoint hotSpot;
+
+    // The image of cursorImage for contentBuffer, created on demand.
+    mutable WBufferDropPtr imageBuffer;
+    quint64 contentSerial = 0;
+    static quint64 lastContentSerial;
 };
+quint64 WQuickCursorPrivate::lastContentSerial = 0;
 
 void WQuickCursorPrivate::setHotSpot(const QPoint &newHotSpot)
 {
@@ -217,6 +223,15 @@ void WQuickCursorPrivate::setSurface(WSurface *surface)
             });
         }
 
+        if (cursorSurfaceItem->surface() != surface) {
+            if (auto oldSurface = cursorSurfaceItem->surface())
+                QObject::disconnect(oldSurface, &WSurface::commit, q, nullptr);
+            // The client may update its cursor buffer in place.
+            QObject::connect(surface, &WSurface::commit, q, [this] {
+                contentSerial = ++lastContentSerial;
+            });
+            contentSerial = ++lastContentSerial;
+        }
         cursorSurfaceItem->setSurface(surface);
         if (textureProvider)
             textureProvider->setProxy(cursorSurfaceItem->wTextureProvider());
@@ -226,6 +241,9 @@ void WQuickCursorPrivate::setSurface(WSurface *surface)
             enterOutput(output);
     } else {
         if (cursorSurfaceItem) {
+            if (auto oldSurface = cursorSurfaceItem->surface())
+                QObject::disconnect(oldSurface, &WSurface::commit, q, nullptr);
+            contentSerial = ++lastContentSerial;
             leaveOutput(output);
             cursorSurfaceItem->deleteLater();
             cursorSurfaceItem = nullptr;
@@ -268,6 +286,8 @@ void WQuickCursorPrivate::updateXCursorManager()
 
 void WQuickCursorPrivate::onImageChanged()
 {
+    imageBuffer.reset();
+    contentSerial = ++lastContentSerial;
     updateImplicitSize();
 
     if (!cursorSurfaceItem) {
@@ -507,6 +527,31 @@ void WQuickCursor::setOutput(WOutput *newOutput)
     Q_EMIT outputChanged();
 }
 
+wlr_buffer *WQuickCursor::contentBuffer(quint64 *serial) const
+{
+    W_DC(WQuickCursor);
+
+    if (serial)
+        *serial = d->contentSerial;
+
+    if (d->cursorSurfaceItem) {
+        auto surface = d->cursorSurfaceItem->surface();
+        return surface ? surface->buffer() : nullptr;
+    }
+
+    if (!d->cursorImage)
+        return nullptr;
+
+    if (!d->imageBuffer) {
+        const QImage &image = d->cursorImage->image();
+        if (image.isNull())
+            return nullptr;
+        d->imageBuffer.reset((new WImageBufferImpl(image))->handle());
+    }
+
+    return d->imageBuffer.get();
+}
+
 void WQuickCursor::invalidateSceneGraph()
 {
     W_D(WQuickCursor);
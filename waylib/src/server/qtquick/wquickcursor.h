@@ -74,6 +74,11 @@ public:
     WOutput *output() const;
     void setOutput(WOutput *newOutput);
 
+    // The cursor's pixels for a cursor plane, the client's cursor buffer or a buffer of the
+    // cursor shape's image. *serial changes with the content, also when the client updates
+    // the same buffer, and is unique across all cursors.
+    wlr_buffer *contentBuffer(quint64 *serial = nullptr) const;
+
 Q_SIGNALS:
     void validChanged();
     void cursorChanged();
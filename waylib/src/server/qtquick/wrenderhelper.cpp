@@ -27,6 +27,7 @@
 
 #include <drm_fourcc.h>
 #include <dlfcn.h>
+#include <xf86drm.h>
 
 WAYLIB_SERVER_BEGIN_NAMESPACE
 
@@ -931,10 +932,11 @@ void WRenderHelper::setupRendererBackend(wlr_backend *testBackend)
             return;
         }
 
+        // Vulkan is only used on request (WLR_RENDERER=vulkan): the dmabuf import, cursor,
+        // capture and buffer blitter paths are still OpenGL only.
         QList<QSGRendererInterface::GraphicsApi> apiList = {
             QSGRendererInterface::OpenGL,
             QSGRendererInterface::Software
-            // TODO: Add vulkan to list.
         };
         wl_display *display = nullptr;
         if (!testBackend) {
@@ -1087,6 +1089,21 @@ static UpdateTextureFunction getUpdateTextFunction(wlr_texture *handle)
     return nullptr;
 }
 
+bool WRenderHelper::supportsExplicitSync(wlr_renderer *renderer, wlr_backend *backend)
+{
+    const int fd = wlr_renderer_get_drm_fd(renderer);
+    if (fd < 0)
+        return false;
+
+    uint64_t timeline = 0;
+    if (drmGetCap(fd, DRM_CAP_SYNCOBJ_TIMELINE, &timeline) != 0 || !timeline)
+        return false;
+
+    // The renderer has to wait on and signal timeline points, and the
+    // backend has to pass them along with the output commits.
+    return renderer->features.timeline && backend->features.timeline;
+}
+
 bool WRenderHelper::makeTexture(QRhi *rhi, wlr_texture *handle, QSGPlainTexture *texture)
 {
     auto updateTexture = getUpdateTextFunction(handle);
@@ -73,6 +73,10 @@ public:
     static void setupRendererBackend(wlr_backend *testBackend = nullptr);
     static QSGRendererInterface::GraphicsApi probe(wlr_backend *testBackend, const QList<QSGRendererInterface::GraphicsApi> &apiList);
 
+    // Whether clients can use wp_linux_drm_syncobj_v1: the DRM device has timeline syncobjs
+    // and both the renderer and the backend support timelines.
+    static bool supportsExplicitSync(wlr_renderer *renderer, wlr_backend *backend);
+
     static bool makeTexture(QRhi *rhi, wlr_texture *handle, QSGPlainTexture *texture);
 
     struct TextureEntry {
@@ -12,6 +12,9 @@
 #include <rhi/qrhi.h>
 #include <private/qsgplaintexture_p.h>
 
+#include <unistd.h>
+#include <utility>
+
 WAYLIB_SERVER_BEGIN_NAMESPACE
 
 class Q_DECL_HIDDEN WSGTextureProviderPrivate : public WObjectPrivate
@@ -158,6 +161,16 @@ void WSGTextureProvider::setBuffer(wlr_buffer *buffer)
 void WSGTextureProvider::setTexture(wlr_texture *texture, wlr_buffer *srcBuffer)
 {
     W_D(WSGTextureProvider);
+    if (texture && texture == d->texture && srcBuffer == d->buffer
+        && !d->ownsTexture && d->qtTexture.rhiTexture()) {
+        // The texture of a shm client buffer lives as long as the surface keeps its size,
+        // wlroots uploads only the damaged parts of the next buffers into it (see
+        // wlr_client_buffer_apply_damage). Keep wrapping the same QRhiTexture.
+        d->flushVulkanStageIfNeeded();
+        Q_EMIT textureChanged();
+        return;
+    }
+
     d->cleanTexture();
     d->texture = texture;
     d->buffer = srcBuffer;
@@ -168,6 +181,69 @@ void WSGTextureProvider::setTexture(wlr_texture *texture, wlr_buffer *srcBuffer)
     Q_EMIT textureChanged();
 }
 
+void WSGTextureProvider::waitForFence(int syncFileFd)
+{
+    W_D(WSGTextureProvider);
+    if (syncFileFd < 0)
+        return;
+
+    auto rhi = d->window ? d->window->rhi() : nullptr;
+    if (!rhi || (rhi->backend() != QRhi::OpenGLES2 && rhi->backend() != QRhi::Vulkan)) {
+        // Only the GPU renderers support wp_linux_drm_syncobj_v1.
+        close(syncFileFd);
+        return;
+    }
+
+    class FenceWaitJob : public QRunnable
+    {
+    public:
+        FenceWaitJob(int fd, wlr_renderer *renderer)
+            : fd(fd), renderer(renderer) { }
+        ~FenceWaitJob() override {
+            if (fd >= 0)
+                close(fd);
+        }
+        void run() override {
+#ifdef ENABLE_VULKAN_RENDER
+            if (wlr_renderer_is_vk(renderer)) {
+                // Qt submits its frame on wlroots' queue, the wait holds it back.
+                if (!waylib_vk_renderer_wait_sync_file(renderer, std::exchange(fd, -1)))
+                    qCWarning(lcWlQtQuickTexture) << "Failed to wait for an acquire fence";
+                return;
+            }
+#endif
+
+            static auto eglCreateSyncKHR =
+                reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"));
+            static auto eglWaitSyncKHR =
+                reinterpret_cast<PFNEGLWAITSYNCKHRPROC>(eglGetProcAddress("eglWaitSyncKHR"));
+            static auto eglDestroySyncKHR =
+                reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"));
+            if (!eglCreateSyncKHR || !eglWaitSyncKHR || !eglDestroySyncKHR)
+                return;
+
+            auto display = eglGetCurrentDisplay();
+            const EGLint attribs[] = { EGL_SYNC_NATIVE_FENCE_FD_ANDROID, fd, EGL_NONE };
+            auto sync = eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID, attribs);
+            if (sync == EGL_NO_SYNC_KHR) {
+                qCWarning(lcWlQtQuickTexture) << "Failed to import an acquire fence";
+                return;
+            }
+            // The EGLSync owns the fd now.
+            fd = -1;
+            eglWaitSyncKHR(display, sync, 0);
+            eglDestroySyncKHR(display, sync);
+        }
+        int fd;
+        wlr_renderer *renderer;
+    };
+
+    // Runs on the main thread with Qt's context current, before the frame samples the
+    // texture. Both renderers queue the wait on the GPU, the CPU never blocks on it.
+    d->window->scheduleRenderJob(new FenceWaitJob(syncFileFd, d->window->renderer()),
+                                 QQuickWindow::BeforeRenderingStage);
+}
+
 void WSGTextureProvider::invalidate()
 {
     W_D(WSGTextureProvider);
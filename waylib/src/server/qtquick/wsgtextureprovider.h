@@ -25,6 +25,8 @@ public:
 
     void setBuffer(wlr_buffer *buffer);
     void setTexture(wlr_texture *texture, wlr_buffer *srcBuffer);
+    // Make the next frame wait for the sync_file on the GPU before sampling, takes the fd.
+    void waitForFence(int syncFileFd);
     void invalidate();
 
     QSGTexture *texture() const override;
@@ -220,6 +220,8 @@ public:
 
         if (frameDoneConnection)
             QObject::disconnect(frameDoneConnection);
+        if (presentationConnection)
+            QObject::disconnect(presentationConnection);
 
         Q_ASSERT(!updateTextureConnection);
 
@@ -274,11 +276,22 @@ public:
 
         if (frameDoneConnection)
             QObject::disconnect(frameDoneConnection);
+        if (presentationConnection)
+            QObject::disconnect(presentationConnection);
         if (!q->window()) // maybe null due to item not fully initialized
             return;
 
         auto rw = q->outputRenderWindow();
         if (Q_LIKELY(rw)) {
+            // afterRendering is emitted before the outputs commit, so the presentation
+            // feedback is bound to the commit that shows this frame.
+            presentationConnection = QObject::connect(rw, &QQuickWindow::afterRendering,
+                                                      q, [this, q] {
+                                                          if (Q_LIKELY((rendered || q->isVisible()) && live)
+                                                              && surface && surface->framePacingOutput()) {
+                                                              surface->notifyTexturedOnOutput(surface->framePacingOutput());
+                                                          }
+                                                      });
             // wayland protocol job should not run in rendering thread, so set context qobject to contentItem
             frameDoneConnection = QObject::connect(rw, &WOutputRenderWindow::renderEnd,
                                                    q, [this, q] (const QList<QPointer<WOutput>> committedOutputs) {
@@ -358,6 +371,7 @@ public:
     qreal alphaModifier = 1.0;
 
     QMetaObject::Connection frameDoneConnection;
+    QMetaObject::Connection presentationConnection;
     mutable WSGTextureProvider *textureProvider = nullptr;
     BufferRef buffer;
     BufferRef pendingBuffer;
@@ -385,6 +399,8 @@ WSurfaceItemContent::~WSurfaceItemContent()
 
     if (d->frameDoneConnection)
         QObject::disconnect(d->frameDoneConnection);
+    if (d->presentationConnection)
+        QObject::disconnect(d->presentationConnection);
 
     //`d->window` will become nullptr in ~QQuickItem
     // Don't move this to private class
@@ -463,6 +479,8 @@ WSGTextureProvider *WSurfaceItemContent::wTextureProvider() const
             } else {
                 d->textureProvider->setBuffer(d->buffer.get());
             }
+            if (d->buffer.get() == d->surface->buffer())
+                d->textureProvider->waitForFence(d->surface->acquireFence());
         }
     }
     return d->textureProvider;
@@ -594,6 +612,8 @@ QSGNode *WSurfaceItemContent::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeD
         } else {
             tp->setBuffer(d->buffer.get());
         }
+        if (d->surface && d->buffer.get() == d->surface->buffer())
+            tp->waitForFence(d->surface->acquireFence());
     }
 
     if (!tp->texture() || width() <= 0 || height() <= 0) {
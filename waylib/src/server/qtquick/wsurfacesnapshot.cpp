@@ -0,0 +1,383 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "wsurfacesnapshot.h"
+#include "wsurfaceitem.h"
+#include "wsgtextureprovider.h"
+#include "woutputrenderwindow.h"
+#include "wsurface.h"
+#include <wpointer.h>
+
+#include <wlr_all.h>
+
+#include <QSGImageNode>
+#include <private/qquickitem_p.h>
+
+#include <memory>
+#include <vector>
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+
+class Q_DECL_HIDDEN WSurfaceSnapshotPrivate : public QQuickItemPrivate
+{
+public:
+    struct Entry
+    {
+        QPointer<WSurfaceItemContent> content;
+        // In sourceItem's coordinates.
+        QRectF rect;
+        // In the buffer's coordinates.
+        QRectF sourceRect;
+        // Only set for captured entries, the lock makes the client's next commit
+        // go to a new texture instead of updating this one in place.
+        WBufferUnlockPtr buffer;
+        std::unique_ptr<WSGTextureProvider> provider;
+    };
+
+    explicit WSurfaceSnapshotPrivate(WSurfaceSnapshot *) {}
+
+    void initSourceItem(QQuickItem *old, QQuickItem *item);
+    void collect(QQuickItem *item);
+    void watch(QQuickItem *item);
+    void watchContent(WSurfaceItemContent *content);
+    void markEntriesDirty();
+    void capture();
+    void clearEntries();
+
+    W_DECLARE_PUBLIC(WSurfaceSnapshot)
+
+    QPointer<QQuickItem> sourceItem;
+    QRectF sourceRect;
+    bool live = false;
+    bool hideSource = false;
+    bool captured = false;
+    // Live entries are only collected again when the surface tree or its geometry changed.
+    bool entriesDirty = true;
+
+    std::vector<Entry> entries;
+    QList<QMetaObject::Connection> connections;
+};
+
+void WSurfaceSnapshotPrivate::initSourceItem(QQuickItem *old, QQuickItem *item)
+{
+    W_Q(WSurfaceSnapshot);
+
+    if (old) {
+        old->disconnect(q);
+        QQuickItemPrivate::get(old)->derefFromEffectItem(hideSource);
+    }
+
+    if (item) {
+        QQuickItemPrivate::get(item)->refFromEffectItem(hideSource);
+        QObject::connect(item, &QQuickItem::destroyed, q, &WSurfaceSnapshot::update);
+    }
+}
+
+// Appends the visible surface contents below item in paint order, live snapshots
+// also watch every item they pass for changes to the entries.
+void WSurfaceSnapshotPrivate::collect(QQuickItem *item)
+{
+    const auto children = QQuickItemPrivate::get(item)->paintOrderChildItems();
+    for (auto child : children) {
+        if (live)
+            watch(child);
+        if (!child->isVisible() || qFuzzyIsNull(child->opacity()))
+            continue;
+
+        if (auto content = qobject_cast<WSurfaceItemContent*>(child)) {
+            const QPointF offset = content->ignoreBufferOffset() ? QPointF() : QPointF(content->bufferOffset());
+            Entry entry;
+            entry.content = content;
+            entry.rect = content->mapRectToItem(sourceItem, QRectF(offset, content->size()));
+            entry.sourceRect = content->bufferSourceRect();
+            entries.push_back(std::move(entry));
+            if (live)
+                watchContent(content);
+        }
+
+        collect(child);
+    }
+}
+
+void WSurfaceSnapshotPrivate::watch(QQuickItem *item)
+{
+    W_Q(WSurfaceSnapshot);
+    auto markDirty = [this] { markEntriesDirty(); };
+    // Added or removed subsurface items change the children.
+    connections << QObject::connect(item, &QQuickItem::childrenChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::zChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::visibleChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::opacityChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::xChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::yChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::widthChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::heightChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::scaleChanged, q, markDirty)
+                << QObject::connect(item, &QQuickItem::rotationChanged, q, markDirty);
+}
+
+void WSurfaceSnapshotPrivate::watchContent(WSurfaceItemContent *content)
+{
+    W_Q(WSurfaceSnapshot);
+    auto markDirty = [this] { markEntriesDirty(); };
+    connections << QObject::connect(content, &WSurfaceItemContent::bufferSourceRectChanged, q, markDirty)
+                << QObject::connect(content, &WSurfaceItemContent::bufferOffsetChanged, q, markDirty)
+                << QObject::connect(content, &WSurfaceItemContent::ignoreBufferOffsetChanged, q, markDirty);
+    // QQuickItem::stackAfter() emits nothing, restacked subsurfaces are only told by the surface.
+    if (auto surface = content->surface())
+        connections << QObject::connect(surface, &WSurface::subsurfaceOrderChanged, q, markDirty);
+    // The texture is read again on every update, a new one needs no new entries.
+    if (auto tp = content->wTextureProvider()) {
+        connections << QObject::connect(tp, &QSGTextureProvider::textureChanged,
+                                        q, &WSurfaceSnapshot::update);
+    }
+}
+
+void WSurfaceSnapshotPrivate::markEntriesDirty()
+{
+    W_Q(WSurfaceSnapshot);
+    entriesDirty = true;
+    q->update();
+}
+
+void WSurfaceSnapshotPrivate::capture()
+{
+    W_Q(WSurfaceSnapshot);
+    auto window = qobject_cast<WOutputRenderWindow*>(q->window());
+
+    for (auto &entry : entries) {
+        auto tp = entry.content->wTextureProvider();
+        auto buffer = tp ? tp->qwBuffer() : nullptr;
+        if (!buffer)
+            continue;
+
+        wlr_buffer_lock(buffer);
+        entry.buffer.reset(buffer);
+        entry.provider = std::make_unique<WSGTextureProvider>(window);
+        entry.provider->setBuffer(buffer);
+        auto surface = entry.content->surface();
+        if (surface && surface->buffer() == buffer)
+            entry.provider->waitForFence(surface->acquireFence());
+    }
+}
+
+void WSurfaceSnapshotPrivate::clearEntries()
+{
+    for (const auto &connection : std::as_const(connections))
+        QObject::disconnect(connection);
+    connections.clear();
+    entries.clear();
+    entriesDirty = true;
+}
+
+WSurfaceSnapshot::WSurfaceSnapshot(QQuickItem *parent)
+    : QQuickItem(*new WSurfaceSnapshotPrivate(this), parent)
+{
+    setFlag(ItemHasContents);
+}
+
+WSurfaceSnapshot::~WSurfaceSnapshot()
+{
+    W_D(WSurfaceSnapshot);
+    d->initSourceItem(d->sourceItem, nullptr);
+    // `d->window` will become nullptr in ~QQuickItem, the providers need it.
+    d->clearEntries();
+}
+
+QQuickItem *WSurfaceSnapshot::sourceItem() const
+{
+    W_DC(WSurfaceSnapshot);
+    return d->sourceItem;
+}
+
+void WSurfaceSnapshot::setSourceItem(QQuickItem *sourceItem)
+{
+    W_D(WSurfaceSnapshot);
+    if (d->sourceItem == sourceItem)
+        return;
+
+    if (isComponentComplete())
+        d->initSourceItem(d->sourceItem, sourceItem);
+
+    d->sourceItem = sourceItem;
+    d->captured = false;
+    d->entriesDirty = true;
+    Q_EMIT sourceItemChanged();
+    update();
+}
+
+QRectF WSurfaceSnapshot::sourceRect() const
+{
+    W_DC(WSurfaceSnapshot);
+    return d->sourceRect;
+}
+
+void WSurfaceSnapshot::setSourceRect(const QRectF &sourceRect)
+{
+    W_D(WSurfaceSnapshot);
+    if (d->sourceRect == sourceRect)
+        return;
+
+    d->sourceRect = sourceRect;
+    Q_EMIT sourceRectChanged();
+    update();
+}
+
+bool WSurfaceSnapshot::live() const
+{
+    W_DC(WSurfaceSnapshot);
+    return d->live;
+}
+
+void WSurfaceSnapshot::setLive(bool live)
+{
+    W_D(WSurfaceSnapshot);
+    if (d->live == live)
+        return;
+
+    d->live = live;
+    d->captured = false;
+    d->entriesDirty = true;
+    Q_EMIT liveChanged();
+    update();
+}
+
+bool WSurfaceSnapshot::hideSource() const
+{
+    W_DC(WSurfaceSnapshot);
+    return d->hideSource;
+}
+
+void WSurfaceSnapshot::setHideSource(bool hideSource)
+{
+    W_D(WSurfaceSnapshot);
+    if (d->hideSource == hideSource)
+        return;
+
+    if (d->sourceItem && isComponentComplete()) {
+        QQuickItemPrivate::get(d->sourceItem)->refFromEffectItem(hideSource);
+        QQuickItemPrivate::get(d->sourceItem)->derefFromEffectItem(d->hideSource);
+    }
+    d->hideSource = hideSource;
+    Q_EMIT hideSourceChanged();
+}
+
+void WSurfaceSnapshot::scheduleUpdate()
+{
+    W_D(WSurfaceSnapshot);
+    d->captured = false;
+    update();
+}
+
+QSGNode *WSurfaceSnapshot::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    W_D(WSurfaceSnapshot);
+
+    if (Q_UNLIKELY(!d->sourceItem || !qobject_cast<WOutputRenderWindow*>(window()))) {
+        d->clearEntries();
+        delete oldNode;
+        return nullptr;
+    }
+
+    if (d->live ? d->entriesDirty : !d->captured) {
+        d->clearEntries();
+        // Entries are relative to the source item, only its children matter.
+        if (d->live) {
+            d->connections << connect(d->sourceItem, &QQuickItem::childrenChanged,
+                                      this, [d] { d->markEntriesDirty(); });
+        }
+        d->collect(d->sourceItem);
+        d->entriesDirty = false;
+
+        if (!d->live) {
+            d->capture();
+            d->captured = true;
+            QMetaObject::invokeMethod(this, &WSurfaceSnapshot::scheduledUpdateCompleted,
+                                      Qt::QueuedConnection);
+        }
+    }
+
+    QRectF sourceRect = d->sourceRect;
+    if (!sourceRect.isValid())
+        sourceRect = QRectF(0, 0, d->sourceItem->width(), d->sourceItem->height());
+    if (sourceRect.isEmpty() || width() <= 0 || height() <= 0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    const qreal xScale = width() / sourceRect.width();
+    const qreal yScale = height() / sourceRect.height();
+
+    auto node = oldNode ? oldNode : new QSGNode;
+    auto image = static_cast<QSGImageNode*>(node->firstChild());
+
+    for (const auto &entry : d->entries) {
+        QSGTexture *texture = nullptr;
+        if (entry.provider) {
+            texture = entry.provider->texture();
+        } else if (!d->live) {
+            // The content had no buffer when captured.
+            continue;
+        } else if (entry.content) {
+            if (auto tp = entry.content->wTextureProvider())
+                texture = tp->texture();
+        }
+
+        const QRectF rect = entry.rect & sourceRect;
+        if (!texture || rect.isEmpty() || entry.rect.isEmpty())
+            continue;
+
+        // Crop the texture the same as the rect when sourceRect cuts into the surface.
+        const qreal bufferXScale = entry.sourceRect.width() / entry.rect.width();
+        const qreal bufferYScale = entry.sourceRect.height() / entry.rect.height();
+        const QRectF textureRect(entry.sourceRect.x() + (rect.x() - entry.rect.x()) * bufferXScale,
+                                 entry.sourceRect.y() + (rect.y() - entry.rect.y()) * bufferYScale,
+                                 rect.width() * bufferXScale,
+                                 rect.height() * bufferYScale);
+
+        if (!image) {
+            image = window()->createImageNode();
+            image->setOwnsTexture(false);
+            image->setFlag(QSGNode::OwnedByParent);
+            node->appendChildNode(image);
+        }
+
+        image->setTexture(texture);
+        image->setSourceRect(textureRect);
+        image->setRect(QRectF((rect.x() - sourceRect.x()) * xScale,
+                              (rect.y() - sourceRect.y()) * yScale,
+                              rect.width() * xScale,
+                              rect.height() * yScale));
+        image->setFiltering(smooth() ? QSGTexture::Linear : QSGTexture::Nearest);
+        image = static_cast<QSGImageNode*>(image->nextSibling());
+    }
+
+    // Drop the nodes left over from a previous frame with more surfaces.
+    while (image) {
+        auto next = static_cast<QSGImageNode*>(image->nextSibling());
+        node->removeChildNode(image);
+        delete image;
+        image = next;
+    }
+
+    return node;
+}
+
+void WSurfaceSnapshot::componentComplete()
+{
+    W_D(WSurfaceSnapshot);
+
+    if (d->sourceItem)
+        d->initSourceItem(nullptr, d->sourceItem);
+
+    QQuickItem::componentComplete();
+}
+
+void WSurfaceSnapshot::releaseResources()
+{
+    W_D(WSurfaceSnapshot);
+    d->clearEntries();
+    d->captured = false;
+}
+
+WAYLIB_SERVER_END_NAMESPACE
@@ -0,0 +1,58 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#pragma once
+
+#include <wglobal.h>
+
+#include <QQuickItem>
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+
+class WSurfaceSnapshotPrivate;
+// Shows the surface contents below sourceItem by referencing the clients' textures
+// directly, a cheaper ShaderEffectSource for items that contain nothing but surfaces.
+// Non surface items (decorations, effects) below sourceItem are not drawn.
+class WAYLIB_SERVER_EXPORT WSurfaceSnapshot : public QQuickItem
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(WSurfaceSnapshot)
+    Q_PROPERTY(QQuickItem* sourceItem READ sourceItem WRITE setSourceItem NOTIFY sourceItemChanged FINAL)
+    Q_PROPERTY(QRectF sourceRect READ sourceRect WRITE setSourceRect NOTIFY sourceRectChanged FINAL)
+    Q_PROPERTY(bool live READ live WRITE setLive NOTIFY liveChanged FINAL)
+    Q_PROPERTY(bool hideSource READ hideSource WRITE setHideSource NOTIFY hideSourceChanged FINAL)
+    QML_NAMED_ELEMENT(SurfaceSnapshot)
+
+public:
+    explicit WSurfaceSnapshot(QQuickItem *parent = nullptr);
+    ~WSurfaceSnapshot() override;
+
+    QQuickItem *sourceItem() const;
+    void setSourceItem(QQuickItem *sourceItem);
+
+    QRectF sourceRect() const;
+    void setSourceRect(const QRectF &sourceRect);
+
+    bool live() const;
+    void setLive(bool live);
+
+    bool hideSource() const;
+    void setHideSource(bool hideSource);
+
+    // Capture the current buffers again when not live, like ShaderEffectSource::scheduleUpdate.
+    Q_INVOKABLE void scheduleUpdate();
+
+Q_SIGNALS:
+    void sourceItemChanged();
+    void sourceRectChanged();
+    void liveChanged();
+    void hideSourceChanged();
+    void scheduledUpdateCompleted();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void componentComplete() override;
+    void releaseResources() override;
+};
+
+WAYLIB_SERVER_END_NAMESPACE
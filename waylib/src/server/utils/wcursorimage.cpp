@@ -7,7 +7,10 @@
 
 #include <wlr_all.h>
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <private/qobject_p.h>
 
@@ -313,19 +316,19 @@ static QList<QByteArray> alternativesCursorShape(const QByteArray &name)
     return QList<QByteArray>();
 }
 
-static inline wlr_xcursor *getXCursorWithFallback(wlr_xcursor_manager *xcursor_manager, const char *name, float scale)
+static inline wlr_xcursor *getXCursorWithFallback(wlr_xcursor_theme *theme, const char *name)
 {
-    if (!xcursor_manager)
+    if (!theme)
         return nullptr;
 
-    if (wlr_xcursor *cursor = wlr_xcursor_manager_get_xcursor(xcursor_manager, name, scale)) {
+    if (wlr_xcursor *cursor = wlr_xcursor_theme_get_cursor(theme, name)) {
         return cursor;
     }
 
     const auto alterNameList = alternativesCursorShape(name);
 
     for (const auto &alterName : alterNameList) {
-        if (auto cursor = wlr_xcursor_manager_get_xcursor(xcursor_manager, alterName, scale))
+        if (auto cursor = wlr_xcursor_theme_get_cursor(theme, alterName))
             return cursor;
     }
 
@@ -479,6 +482,120 @@ static inline const char *qcursorShapeToType(std::underlying_type_t<WGlobal::Cur
     return nullptr;
 }
 
+// The frames of a cursor shape, copied out of the theme once and shared by all
+// the cursor images showing it.
+struct Q_DECL_HIDDEN XCursorShape
+{
+    struct Frame
+    {
+        QImage image;
+        QPoint hotSpot;
+        uint32_t delay = 0;
+    };
+
+    QList<Frame> frames;
+};
+
+// A xcursor theme at one pixel size, shared by all the cursor images using it, e.g. a
+// size 24 cursor on a 2x output and a size 48 cursor on a 1x output. The theme is
+// parsed on a worker thread, the cursor images keep showing their previous theme
+// until it is loaded.
+class Q_DECL_HIDDEN XCursorTheme : public std::enable_shared_from_this<XCursorTheme>
+{
+public:
+    using Key = std::pair<QByteArray, uint32_t>;
+
+    explicit XCursorTheme(const Key &key)
+        : key(key) { }
+    ~XCursorTheme() {
+        if (theme)
+            wlr_xcursor_theme_destroy(theme);
+    }
+
+    static std::shared_ptr<XCursorTheme> get(const QByteArray &name, uint32_t pixelSize);
+
+    bool isLoaded() const { return loaded; }
+    // Returns nullptr if the theme has no such shape or isn't loaded yet.
+    std::shared_ptr<const XCursorShape> shape(const char *name);
+
+    const Key key;
+
+private:
+    void load();
+    void onLoaded(wlr_xcursor_theme *theme);
+
+    wlr_xcursor_theme *theme = nullptr;
+    bool loaded = false;
+    // Keyed by the requested name, the alternative names are already resolved.
+    QHash<QByteArray, std::shared_ptr<const XCursorShape>> shapes;
+
+    static thread_local QHash<Key, std::weak_ptr<XCursorTheme>> themes;
+};
+thread_local QHash<XCursorTheme::Key, std::weak_ptr<XCursorTheme>> XCursorTheme::themes;
+
+std::shared_ptr<XCursorTheme> XCursorTheme::get(const QByteArray &name, uint32_t pixelSize)
+{
+    const Key key(name, pixelSize);
+    if (auto theme = themes.value(key).lock())
+        return theme;
+
+    // Drop the entries of the themes nobody uses anymore.
+    themes.removeIf([](const auto &it) {
+        return it.value().expired();
+    });
+
+    auto theme = std::make_shared<XCursorTheme>(key);
+    themes.insert(key, theme);
+    theme->load();
+    return theme;
+}
+
+void XCursorTheme::load()
+{
+    Q_ASSERT(QThread::currentThread() == qApp->thread());
+
+    std::weak_ptr<XCursorTheme> self = weak_from_this();
+    QThreadPool::globalInstance()->start([self, key = key] {
+        // Only reads files, nothing here touches the compositor's state.
+        auto theme = wlr_xcursor_theme_load(key.first.constData(), key.second);
+        QMetaObject::invokeMethod(qApp, [self, theme] {
+            if (auto that = self.lock())
+                that->onLoaded(theme);
+            else if (theme)
+                wlr_xcursor_theme_destroy(theme);
+        }, Qt::QueuedConnection);
+    });
+}
+
+std::shared_ptr<const XCursorShape> XCursorTheme::shape(const char *name)
+{
+    if (!theme)
+        return nullptr;
+
+    auto it = shapes.constFind(name);
+    if (it != shapes.constEnd())
+        return *it;
+
+    std::shared_ptr<XCursorShape> shape;
+    if (auto xcursor = getXCursorWithFallback(theme, name); xcursor && xcursor->image_count > 0) {
+        shape = std::make_shared<XCursorShape>();
+        shape->frames.reserve(xcursor->image_count);
+        for (unsigned int i = 0; i < xcursor->image_count; ++i) {
+            auto ximage = xcursor->images[i];
+            // Deep copy, the image may outlive the theme in the render thread.
+            QImage image = QImage(static_cast<const uchar*>(ximage->buffer),
+                                  ximage->width, ximage->height,
+                                  QImage::Format_ARGB32_Premultiplied).copy();
+            shape->frames.append({ std::move(image),
+                                   QPoint(ximage->hotspot_x, ximage->hotspot_y),
+                                   ximage->delay });
+        }
+    }
+
+    shapes.insert(name, shape);
+    return shape;
+}
+
 class Q_DECL_HIDDEN WCursorImagePrivate : public QObjectPrivate {
 public:
     WCursorImagePrivate() {
@@ -490,20 +607,29 @@ public:
         Q_ASSERT(ok);
     }
 
-    void setImage(const QImage &image, const QPoint &hotspot);
+    void setImage(const QImage &image, const QPoint &hotspot, float devicePixelRatio);
+    void updateTheme();
     void updateCursorImage();
     void playXCursor();
 
+    static void onThemeLoaded(XCursorTheme *theme);
+
     W_DECLARE_PUBLIC(WCursorImage)
 
     QImage image;// TODO: supports multi threads
     QPoint hotSpot;
 
     QCursor cursor;
-    std::shared_ptr<wlr_xcursor_manager> manager;
+    QByteArray themeName;
+    uint32_t themeSize = 0;
     float scale = 1.0;
 
-    wlr_xcursor *xcursor = nullptr;
+    std::shared_ptr<XCursorTheme> theme;
+    // The scale `theme` is used with, `scale` may be waiting for pendingTheme.
+    float themeScale = 1.0;
+    std::shared_ptr<XCursorTheme> pendingTheme;
+
+    std::shared_ptr<const XCursorShape> xcursor;
     int currentXCursorImageIndex = 0;
     QTimer *xcursorPlayTimer = nullptr;
 
@@ -511,13 +637,68 @@ public:
 };
 thread_local QList<WCursorImagePrivate*> WCursorImagePrivate::cursorImages;
 
-void WCursorImagePrivate::setImage(const QImage &image, const QPoint &hotspot) {
+void XCursorTheme::onLoaded(wlr_xcursor_theme *theme)
+{
+    Q_ASSERT(!loaded);
+    this->theme = theme;
+    loaded = true;
+
+    if (!theme)
+        qCCritical(lcWlCursorImage) << "Can't load cursor theme:" << key.first << ", size:" << key.second;
+
+    WCursorImagePrivate::onThemeLoaded(this);
+}
+
+void WCursorImagePrivate::onThemeLoaded(XCursorTheme *theme)
+{
+    for (auto dd : std::as_const(cursorImages)) {
+        if (dd->pendingTheme.get() != theme)
+            continue;
+
+        dd->theme = std::move(dd->pendingTheme);
+        dd->themeScale = dd->scale;
+        dd->updateCursorImage();
+    }
+}
+
+void WCursorImagePrivate::setImage(const QImage &image, const QPoint &hotspot, float devicePixelRatio) {
     this->image = image;
-    this->image.setDevicePixelRatio(scale);
+    this->image.setDevicePixelRatio(devicePixelRatio);
     this->hotSpot = hotspot;
     Q_EMIT q_func()->imageChanged();
 }
 
+void WCursorImagePrivate::updateTheme()
+{
+    if (themeSize == 0)
+        return;
+
+    const XCursorTheme::Key key(themeName, uint32_t(themeSize * scale));
+    if (theme && theme->key == key) {
+        pendingTheme.reset();
+        if (!qFuzzyCompare(themeScale, scale)) {
+            themeScale = scale;
+            updateCursorImage();
+        }
+        return;
+    }
+
+    if (pendingTheme && pendingTheme->key == key)
+        return;
+
+    auto newTheme = XCursorTheme::get(themeName, key.second);
+    if (!newTheme->isLoaded()) {
+        // Keep showing the current theme until the new one is loaded.
+        pendingTheme = std::move(newTheme);
+        return;
+    }
+
+    pendingTheme.reset();
+    theme = std::move(newTheme);
+    themeScale = scale;
+    updateCursorImage();
+}
+
 void WCursorImagePrivate::updateCursorImage()
 {
     xcursor = nullptr;
@@ -529,35 +710,32 @@ void WCursorImagePrivate::updateCursorImage()
         tempTimer->stop();
 
     if (cursor.shape() == Qt::BitmapCursor) {
-        setImage(cursor.pixmap().toImage(), cursor.hotSpot());
+        setImage(cursor.pixmap().toImage(), cursor.hotSpot(), scale);
         return;
     }
 
-    if (!manager || cursor.shape() == Qt::BlankCursor) {
-        setImage(QImage(), {});
+    if (!theme || cursor.shape() == Qt::BlankCursor) {
+        setImage(QImage(), {}, scale);
         return;
     }
 
     auto cursorName = qcursorShapeToType(cursor.shape());
     if (cursorName) {
-        xcursor = getXCursorWithFallback(manager.get(), cursorName, scale);
+        xcursor = theme->shape(cursorName);
         if (!xcursor)
             qCWarning(lcWlCursorImage) << "Get empty cursor image for " << cursorName;
     } else {
         qCWarning(lcWlCursorImage) << "Unknown cursor shape type!";
     }
 
-    if (!xcursor || xcursor->image_count == 0) {
-        setImage(QImage(), {});
+    if (!xcursor) {
+        setImage(QImage(), {}, scale);
         return;
     }
 
-    if (xcursor->image_count == 1) {
-        auto ximage = xcursor->images[0];
-        setImage(QImage(static_cast<const uchar*>(ximage->buffer),
-                        ximage->width, ximage->height,
-                        QImage::Format_ARGB32_Premultiplied),
-                 QPoint(ximage->hotspot_x, ximage->hotspot_y));
+    if (xcursor->frames.size() == 1) {
+        const auto &frame = xcursor->frames.first();
+        setImage(frame.image, frame.hotSpot, themeScale);
         return;
     }
 
@@ -576,18 +754,15 @@ void WCursorImagePrivate::updateCursorImage()
 void WCursorImagePrivate::playXCursor()
 {
     Q_ASSERT(xcursor);
-    Q_ASSERT(static_cast<unsigned int>(currentXCursorImageIndex) < xcursor->image_count);
+    Q_ASSERT(currentXCursorImageIndex < xcursor->frames.size());
     Q_ASSERT(xcursorPlayTimer);
     Q_ASSERT(!xcursorPlayTimer->isActive());
 
-    auto ximage = xcursor->images[currentXCursorImageIndex];
-    setImage(QImage(static_cast<const uchar*>(ximage->buffer),
-                    ximage->width, ximage->height,
-                    QImage::Format_ARGB32_Premultiplied),
-             QPoint(ximage->hotspot_x, ximage->hotspot_y));
+    const auto &frame = xcursor->frames.at(currentXCursorImageIndex);
+    setImage(frame.image, frame.hotSpot, themeScale);
 
-    currentXCursorImageIndex = (currentXCursorImageIndex + 1) % xcursor->image_count;
-    xcursorPlayTimer->start(ximage->delay);
+    currentXCursorImageIndex = (currentXCursorImageIndex + 1) % xcursor->frames.size();
+    xcursorPlayTimer->start(frame.delay);
 }
 
 WCursorImage::WCursorImage(QObject *parent)
@@ -637,46 +812,22 @@ void WCursorImage::setScale(float newScale)
     if (qFuzzyCompare(d->scale, newScale))
         return;
     d->scale = newScale;
-    if (d->manager)
-        wlr_xcursor_manager_load(d->manager.get(), d->scale);
-
-    d->updateCursorImage();
+    d->updateTheme();
+    if (d->cursor.shape() == Qt::BitmapCursor)
+        d->updateCursorImage();
     Q_EMIT scaleChanged();
 }
 
-static inline bool matchCursorTheme(const wlr_xcursor_manager *manager,
-                                    const QByteArray &name, uint32_t size) {
-    return manager && manager->name == name && manager->size == size;
-}
-
 void WCursorImage::setCursorTheme(const QByteArray &name, uint32_t size)
 {
     Q_D(WCursorImage);
 
-    if (matchCursorTheme(d->manager.get(), name, size)) {
+    if (d->themeName == name && d->themeSize == size)
         return;
-    }
-
-    d->manager.reset();
-    for (auto dd : std::as_const(WCursorImagePrivate::cursorImages)) {
-        if (dd == d)
-            continue;
-
-        if (matchCursorTheme(dd->manager.get(), name, size)) {
-            d->manager = dd->manager;
-            break;
-        }
-    }
-    if (!d->manager)
-        d->manager = std::shared_ptr<wlr_xcursor_manager>(
-            wlr_xcursor_manager_create(name.constData(), size),
-            wlr_xcursor_manager_destroy);
 
-    bool theme_loaded = wlr_xcursor_manager_load(d->manager.get(), d->scale);
-    if (!theme_loaded)
-        qCCritical(lcWlCursorImage) << "Can't load cursor theme:" << name << ", size:" << size;
-
-    d->updateCursorImage();
+    d->themeName = name;
+    d->themeSize = size;
+    d->updateTheme();
 }
 
 WAYLIB_SERVER_END_NAMESPACE
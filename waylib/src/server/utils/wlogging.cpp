@@ -0,0 +1,207 @@
+// Copyright (C) 2026 UnionTech Software Technology Co., Ltd.
+// SPDX-License-Identifier: Apache-2.0 OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "wlogging.h"
+#include "wayliblogging.h"
+
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <array>
+#include <cstdio>
+#include <memory>
+
+WAYLIB_SERVER_BEGIN_NAMESPACE
+
+static void writeMessage(wlr_log_importance verbosity, const char *message)
+{
+    switch (verbosity) {
+    case WLR_ERROR:
+        qCCritical(lcWlroots) << message;
+        break;
+    case WLR_INFO:
+        qCInfo(lcWlroots) << message;
+        break;
+    case WLR_DEBUG:
+        qCDebug(lcWlroots) << message;
+        break;
+    default:
+        break;
+    }
+}
+
+class Q_DECL_HIDDEN AsyncLogSink
+{
+public:
+    AsyncLogSink()
+        : m_thread(QThread::create([this] { run(); }))
+    {
+        m_thread->setObjectName(QStringLiteral("wlroots-log"));
+        m_thread->start(QThread::LowPriority);
+    }
+
+    ~AsyncLogSink()
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_quit = true;
+            m_cond.wakeOne();
+        }
+        m_thread->wait();
+    }
+
+    void push(wlr_log_importance verbosity, const char *fmt, va_list args)
+    {
+        // Format outside of the lock, the writer only ever waits for a copy.
+        Entry entry;
+        entry.verbosity = verbosity;
+        vsnprintf(entry.message, sizeof(entry.message), fmt, args);
+
+        QMutexLocker locker(&m_mutex);
+        if (m_count == m_entries.size()) {
+            ++m_dropped;
+            return;
+        }
+        m_entries[(m_head + m_count) % m_entries.size()] = entry;
+        ++m_count;
+        m_cond.wakeOne();
+    }
+
+private:
+    struct Entry
+    {
+        wlr_log_importance verbosity;
+        char message[512];
+    };
+
+    void run()
+    {
+        QMutexLocker locker(&m_mutex);
+        while (true) {
+            while (!m_quit && m_count == 0 && m_dropped == 0)
+                m_cond.wait(&m_mutex);
+
+            if (m_dropped > 0) {
+                const auto dropped = m_dropped;
+                m_dropped = 0;
+                locker.unlock();
+                qCWarning(lcWlroots, "Dropped %zu messages, the log buffer was full", dropped);
+                locker.relock();
+            }
+
+            if (m_count == 0) {
+                if (m_quit)
+                    return;
+                continue;
+            }
+
+            const Entry entry = m_entries[m_head];
+            m_head = (m_head + 1) % m_entries.size();
+            --m_count;
+
+            locker.unlock();
+            writeMessage(entry.verbosity, entry.message);
+            locker.relock();
+        }
+    }
+
+    std::unique_ptr<QThread> m_thread;
+    QMutex m_mutex;
+    QWaitCondition m_cond;
+    std::array<Entry, 1024> m_entries;
+    size_t m_head = 0;
+    size_t m_count = 0;
+    size_t m_dropped = 0;
+    bool m_quit = false;
+};
+
+static std::unique_ptr<AsyncLogSink> asyncSink;
+static QLoggingCategory::CategoryFilter previousCategoryFilter = nullptr;
+// Set while the default callback is installed. wlroots has no getter for its callback,
+// and wlr_log_init(level, nullptr) would replace it with the stderr one.
+static wlr_log_func_t installedDefaultCallback = nullptr;
+
+static wlr_log_importance verbosityOf(const QLoggingCategory *category)
+{
+    if (category->isDebugEnabled())
+        return WLR_DEBUG;
+    if (category->isInfoEnabled())
+        return WLR_INFO;
+    if (category->isCriticalEnabled())
+        return WLR_ERROR;
+    return WLR_SILENT;
+}
+
+// Called for every category whenever the logging rules are (re)applied,
+// keeps wlroots' own verbosity in sync with the "wlroots" category. A custom
+// callback keeps the verbosity it was installed with.
+static void categoryFilter(QLoggingCategory *category)
+{
+    if (previousCategoryFilter)
+        previousCategoryFilter(category);
+
+    if (installedDefaultCallback
+        && qstrcmp(category->categoryName(), lcWlroots().categoryName()) == 0) {
+        wlr_log_init(verbosityOf(category), installedDefaultCallback);
+    }
+}
+
+void WLog::init(Sink sink)
+{
+    if (sink == Sink::Async && !asyncSink)
+        asyncSink = std::make_unique<AsyncLogSink>();
+    else if (sink == Sink::Direct)
+        asyncSink.reset();
+
+    installedDefaultCallback = &defaultLogCallback;
+    wlr_log_init(verbosityOf(&lcWlroots()), installedDefaultCallback);
+
+    static bool filterInstalled = false;
+    if (!filterInstalled) {
+        filterInstalled = true;
+        previousCategoryFilter = QLoggingCategory::installFilter(&categoryFilter);
+    }
+}
+
+void WLog::init(wlr_log_importance verbosity, wlr_log_func_t callback)
+{
+    installedDefaultCallback = nullptr;
+    wlr_log_init(verbosity, callback);
+}
+
+// Forward wlroots C log messages into the Qt logging system so they honor
+// QT_LOGGING_RULES and Qt's message pattern instead of raw stderr output.
+void WLog::defaultLogCallback(wlr_log_importance verbosity, const char *fmt, va_list args)
+{
+    QtMsgType type;
+    switch (verbosity) {
+    case WLR_ERROR:
+        type = QtCriticalMsg;
+        break;
+    case WLR_INFO:
+        type = QtInfoMsg;
+        break;
+    case WLR_DEBUG:
+        type = QtDebugMsg;
+        break;
+    default:
+        return;
+    }
+
+    // wlroots calls back regardless of its verbosity, drop filtered messages
+    // before paying for the formatting.
+    if (!lcWlroots().isEnabled(type))
+        return;
+
+    if (asyncSink) {
+        asyncSink->push(verbosity, fmt, args);
+        return;
+    }
+
+    const QString message = QString::vasprintf(fmt, args);
+    writeMessage(verbosity, qPrintable(message));
+}
+
+WAYLIB_SERVER_END_NAMESPACE
@@ -18,15 +18,23 @@ WAYLIB_SERVER_BEGIN_NAMESPACE
 class WAYLIB_SERVER_EXPORT WLog
 {
 public:
+    enum class Sink {
+        // Format and write each message in the thread that logged it.
+        Direct,
+        // Queue messages in a ring buffer and write them from a background
+        // thread, so logging doesn't stall the compositor's event loop.
+        // Messages are dropped (and counted) while the buffer is full.
+        Async,
+    };
+
     // Install the default callback, which routes wlroots messages to the
-    // "wlroots" Qt logging category.
-    static void init(wlr_log_importance verbosity = WLR_DEBUG) {
-        init(verbosity, &defaultLogCallback);
-    }
-    // Install a custom wlroots log callback (e.g. for testing or capture).
-    static void init(wlr_log_importance verbosity, wlr_log_func_t callback) {
-        wlr_log_init(verbosity, callback);
-    }
+    // "wlroots" Qt logging category. The wlroots verbosity follows the
+    // category's enabled levels and is updated when the logging rules change,
+    // so disabled messages are neither formatted nor prepared by wlroots.
+    static void init(Sink sink = Sink::Direct);
+    // Install a custom wlroots log callback (e.g. for testing or capture). It
+    // keeps the given verbosity when the logging rules change.
+    static void init(wlr_log_importance verbosity, wlr_log_func_t callback);
 
 private:
     static void defaultLogCallback(wlr_log_importance verbosity, const char *fmt, va_list args);
@@ -3,8 +3,6 @@
 
 #include "wayliblogging.h"
 
-#include <wlogging.h>
-
 // Waylib logging category definitions
 // Naming convention: lcWl + PascalCase module name
 // String ID convention: waylib.<module>[.<submodule>] or waylib.protocols.<name> or waylib.qtquick.<name> or waylib.utils.<name>
@@ -80,26 +78,3 @@ Q_LOGGING_CATEGORY(lcWlPlatform, "waylib.platform", QtWarningMsg)          // QP
 Q_LOGGING_CATEGORY(lcWlRenderHelper, "waylib.render.helper", QtWarningMsg) // Render target creation and buffer import
 Q_LOGGING_CATEGORY(lcWlRenderBuffer, "waylib.render.buffer", QtWarningMsg) // Render buffer node DMA-BUF
 Q_LOGGING_CATEGORY(lcWlBufferRenderer, "waylib.render.bufferrenderer", QtWarningMsg) // Buffer renderer texture provider
-
-// Forward wlroots C log messages into the Qt logging system so they honor
-// QT_LOGGING_RULES and Qt's message pattern instead of raw stderr output.
-WAYLIB_SERVER_BEGIN_NAMESPACE
-void WLog::defaultLogCallback(wlr_log_importance verbosity, const char *fmt, va_list args)
-{
-    const QString message = QString::vasprintf(fmt, args);
-    switch (verbosity) {
-    case WLR_ERROR:
-        qCCritical(lcWlroots) << qPrintable(message);
-        break;
-    case WLR_INFO:
-        qCInfo(lcWlroots) << qPrintable(message);
-        break;
-    case WLR_DEBUG:
-        qCDebug(lcWlroots) << qPrintable(message);
-        break;
-    default:
-        break;
-    }
-}
-
-WAYLIB_SERVER_END_NAMESPACE
@@ -4,6 +4,7 @@
 #include <wlogging.h>
 
 #include <QtTest>
+#include <QMutex>
 #include <cstdarg>
 
 WAYLIB_SERVER_USE_NAMESPACE
@@ -24,6 +25,23 @@ static void testCallback(wlr_log_importance verbosity, const char *fmt, va_list
     g_lastVerbosity = verbosity;
 }
 
+// Collects what the default callback writes to the "wlroots" category, the
+// async sink writes from its own thread.
+static QMutex g_qtMessagesMutex;
+static QStringList g_qtMessages;
+static QtMessageHandler g_previousHandler = nullptr;
+
+static void qtMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    if (qstrcmp(context.category, "wlroots") == 0) {
+        QMutexLocker locker(&g_qtMessagesMutex);
+        g_qtMessages.append(msg);
+        return;
+    }
+    if (g_previousHandler)
+        g_previousHandler(type, context, msg);
+}
+
 class TestWLog : public QObject
 {
     Q_OBJECT
@@ -31,6 +49,11 @@ private Q_SLOTS:
     void initInstallsCallback();
     void initVerbosityFilters();
     void initRestoresDefaultCallback();
+    void filterRulesUpdateVerbosity();
+    void filterRulesKeepCustomCallback();
+    void asyncSinkWritesMessages();
+
+    void cleanup();
 };
 
 void TestWLog::initInstallsCallback()
@@ -72,6 +95,65 @@ void TestWLog::initRestoresDefaultCallback()
     QCOMPARE(g_messageCount, 1);
 }
 
+void TestWLog::filterRulesUpdateVerbosity()
+{
+    WLog::init();
+
+    QLoggingCategory::setFilterRules(QStringLiteral("wlroots.debug=true"));
+    QCOMPARE(wlr_log_get_verbosity(), WLR_DEBUG);
+    QLoggingCategory::setFilterRules(QStringLiteral("wlroots.debug=false\nwlroots.info=true"));
+    QCOMPARE(wlr_log_get_verbosity(), WLR_INFO);
+    QLoggingCategory::setFilterRules(QStringLiteral("wlroots.*=false"));
+    QCOMPARE(wlr_log_get_verbosity(), WLR_SILENT);
+
+    // Still the default callback, the messages reach the category.
+    QLoggingCategory::setFilterRules(QStringLiteral("wlroots.info=true"));
+    g_previousHandler = qInstallMessageHandler(qtMessageHandler);
+    // _wlr_log(), wlr_log() puts "[file:line] " in front of the message.
+    _wlr_log(WLR_INFO, "after the rules %d", 1);
+    qInstallMessageHandler(g_previousHandler);
+    QCOMPARE(g_qtMessages, QStringList{ QStringLiteral("after the rules 1") });
+}
+
+void TestWLog::filterRulesKeepCustomCallback()
+{
+    // Installs the category filter.
+    WLog::init();
+    g_messageCount = 0;
+    WLog::init(WLR_DEBUG, &testCallback);
+
+    QLoggingCategory::setFilterRules(QStringLiteral("wlroots.*=false"));
+    QCOMPARE(wlr_log_get_verbosity(), WLR_DEBUG);
+    wlr_log(WLR_DEBUG, "still custom");
+    QCOMPARE(g_messageCount, 1);
+}
+
+void TestWLog::asyncSinkWritesMessages()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("wlroots.info=true\nwlroots.debug=false"));
+    g_previousHandler = qInstallMessageHandler(qtMessageHandler);
+
+    WLog::init(WLog::Sink::Async);
+    for (int i = 0; i < 3; ++i)
+        _wlr_log(WLR_INFO, "async %d", i);
+    // Filtered before it's queued.
+    _wlr_log(WLR_DEBUG, "async debug");
+    // Switching back stops the writer thread once the queue is empty.
+    WLog::init(WLog::Sink::Direct);
+
+    qInstallMessageHandler(g_previousHandler);
+    const QStringList expected{ QStringLiteral("async 0"),
+                                QStringLiteral("async 1"),
+                                QStringLiteral("async 2") };
+    QCOMPARE(g_qtMessages, expected);
+}
+
+void TestWLog::cleanup()
+{
+    QLoggingCategory::setFilterRules(QString());
+    g_qtMessages.clear();
+}
+
 QTEST_GUILESS_MAIN(TestWLog)
 
 #include "main.moc"